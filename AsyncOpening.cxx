@@ -0,0 +1,152 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "AsyncOpening.h"
+
+// Custom
+#include "CompactGraph.h"
+#include "OpeningEngine.h"
+
+// Reports progress and cancels the engine when asked to or when the deadline has passed.
+class AsyncObserver : public NullObserver
+{
+public:
+  explicit AsyncObserver(const AsyncOpeningState& state) : State(state), NumberOfEdgesProcessed(0), DeadlineExceeded(false) {}
+
+  template <typename TIndex>
+  void Eroded(const unsigned int round, const std::vector<TIndex>&, const size_t, const size_t numberOfEdgesRemoved)
+  {
+    Report(false, round, numberOfEdgesRemoved);
+  }
+
+  template <typename TIndex>
+  void Dilated(const unsigned int dilation, const std::vector<TIndex>&, const size_t numberOfEdgesRestored)
+  {
+    Report(true, dilation, numberOfEdgesRestored);
+  }
+
+  bool Cancelled()
+  {
+    if(State.CancelRequested)
+      {
+      return true;
+      }
+    if(std::chrono::steady_clock::now() > State.Options.Deadline)
+      {
+      DeadlineExceeded = true;
+      return true;
+      }
+    return false;
+  }
+
+  bool WasDeadlineExceeded() const
+  {
+    return DeadlineExceeded;
+  }
+
+private:
+  void Report(const bool dilating, const unsigned int round, const size_t numberOfEdges)
+  {
+    NumberOfEdgesProcessed += numberOfEdges;
+    if(State.Options.Progress)
+      {
+      AsyncOpeningProgress progress = {dilating, round, NumberOfEdgesProcessed};
+      State.Options.Progress(progress);
+      }
+  }
+
+  const AsyncOpeningState& State;
+  size_t NumberOfEdgesProcessed;
+  bool DeadlineExceeded;
+};
+
+template <typename TStoppingPolicy>
+static AsyncOpeningResult OpenAsync(const Graph& g, const TStoppingPolicy stopping, const AsyncOpeningState& state)
+{
+  AsyncOpeningResult result;
+  result.Status = AsyncOpeningCompleted;
+  result.NumberOfErosions = 0;
+
+  AsyncObserver observer(state);
+  if(observer.Cancelled())
+    {
+    result.Status = observer.WasDeadlineExceeded() ? AsyncOpeningDeadlineExceeded : AsyncOpeningCancelled;
+    return result;
+    }
+
+  CompactGraph compactGraph = CreateCompactGraph(g);
+  OpeningEngine<CompactGraph, TStoppingPolicy, AsyncObserver> engine;
+  engine.SetDegreeThreshold(state.Options.DegreeThreshold);
+  engine.Open(compactGraph, stopping, observer, result.Keep);
+  result.NumberOfErosions = engine.GetNumberOfErosions();
+  if(engine.WasCancelled())
+    {
+    result.Status = observer.WasDeadlineExceeded() ? AsyncOpeningDeadlineExceeded : AsyncOpeningCancelled;
+    result.Keep.clear();
+    }
+  return result;
+}
+
+template <typename TStoppingPolicy>
+static AsyncOpeningHandle StartOpening(const Graph& g, const TStoppingPolicy stopping, const AsyncOpeningOptions& options)
+{
+  std::shared_ptr<AsyncOpeningState> state = std::make_shared<AsyncOpeningState>();
+  state->Options = options;
+
+  // The thread holds its own reference to the state, so it outlives a handle which is moved from
+  std::future<AsyncOpeningResult> result = std::async(std::launch::async, [&g, stopping, state]()
+    {
+    return OpenAsync(g, stopping, *state);
+    });
+  return AsyncOpeningHandle(state, std::move(result));
+}
+
+AsyncOpeningHandle& AsyncOpeningHandle::operator=(AsyncOpeningHandle&& other)
+{
+  if(this != &other)
+    {
+    if(Result.valid())
+      {
+      Cancel();
+      Result.wait();
+      }
+    State = std::move(other.State);
+    Result = std::move(other.Result);
+    }
+  return *this;
+}
+
+AsyncOpeningHandle::~AsyncOpeningHandle()
+{
+  if(Result.valid())
+    {
+    Cancel();
+    Result.wait();
+    }
+}
+
+AsyncOpeningHandle OpenGraphFixedAsync(const Graph& g, unsigned int numberOfIterations, const AsyncOpeningOptions& options)
+{
+  return StartOpening(g, FixedIterations(numberOfIterations), options);
+}
+
+AsyncOpeningHandle OpenGraphNullRemovalDifferenceAsync(const Graph& g, unsigned int goalSuccessiveNullDifferences,
+                                                       const AsyncOpeningOptions& options)
+{
+  return StartOpening(g, NullRemovalDifference(goalSuccessiveNullDifferences), options);
+}
@@ -0,0 +1,142 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef ASYNCOPENING_H
+#define ASYNCOPENING_H
+
+// STL
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+// Custom
+#include "Types.h"
+
+// How an asynchronous opening ended
+enum AsyncOpeningStatus
+{
+  AsyncOpeningCompleted,
+  AsyncOpeningCancelled,
+  AsyncOpeningDeadlineExceeded
+};
+
+// Reported after every erosion and dilation.
+struct AsyncOpeningProgress
+{
+  bool Dilating;
+
+  // The erosion or dilation (starting at 1) which just finished
+  unsigned int Round;
+
+  // The number of edges removed and added back so far
+  size_t NumberOfEdgesProcessed;
+};
+
+struct AsyncOpeningOptions
+{
+  AsyncOpeningOptions() : DegreeThreshold(1), Deadline(std::chrono::steady_clock::time_point::max()) {}
+
+  unsigned int DegreeThreshold;
+
+  // The opening is abandoned at the first round which starts after the deadline.
+  std::chrono::steady_clock::time_point Deadline;
+
+  // Called from the thread doing the opening, so it should return quickly. May be empty.
+  std::function<void (const AsyncOpeningProgress&)> Progress;
+};
+
+struct AsyncOpeningResult
+{
+  AsyncOpeningStatus Status;
+
+  // The keep-mask of the opened graph, indexed in the order of boost::edges(). Empty unless Status is
+  // AsyncOpeningCompleted.
+  std::vector<bool> Keep;
+
+  // The number of erosions performed, including those of an abandoned opening.
+  unsigned int NumberOfErosions;
+};
+
+// The shared state of an asynchronous opening
+struct AsyncOpeningState
+{
+  AsyncOpeningState() : CancelRequested(false) {}
+
+  std::atomic<bool> CancelRequested;
+  AsyncOpeningOptions Options;
+};
+
+// A handle to an opening running on its own thread. Cancellation is cooperative: it is checked before
+// every erosion and dilation, so a request takes effect within one round. Destroying a handle whose
+// opening has not finished cancels it and waits for its thread.
+class AsyncOpeningHandle
+{
+public:
+  AsyncOpeningHandle(std::shared_ptr<AsyncOpeningState> state, std::future<AsyncOpeningResult> result)
+    : State(state), Result(std::move(result)) {}
+
+  AsyncOpeningHandle(AsyncOpeningHandle&&) = default;
+
+  // Like destroying it, assigning over a handle whose opening has not finished cancels it and waits for its thread.
+  AsyncOpeningHandle& operator=(AsyncOpeningHandle&& other);
+
+  ~AsyncOpeningHandle();
+
+  // Ask the opening to stop. It may still complete if it is past its last check.
+  void Cancel()
+  {
+    State->CancelRequested = true;
+  }
+
+  // Whether Get() would return without blocking.
+  bool IsReady() const
+  {
+    return Result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  }
+
+  // Wait for at most 'timeout'; returns IsReady().
+  template <typename TRep, typename TPeriod>
+  bool WaitFor(const std::chrono::duration<TRep, TPeriod>& timeout) const
+  {
+    return Result.wait_for(timeout) == std::future_status::ready;
+  }
+
+  // Wait for the opening to end and return its result. May only be called once.
+  AsyncOpeningResult Get()
+  {
+    return Result.get();
+  }
+
+private:
+  std::shared_ptr<AsyncOpeningState> State;
+  std::future<AsyncOpeningResult> Result;
+};
+
+// Start opening 'g' on a new thread. 'g' must stay alive and unchanged until the opening has ended.
+// The results are the same as OpenGraphFixedTracking and OpenGraphNullRemovalDifferenceTracking
+// (with a degree threshold of 1), see CreateGraphFromKeepMask to build the opened graph.
+AsyncOpeningHandle OpenGraphFixedAsync(const Graph& g, unsigned int numberOfIterations,
+                                       const AsyncOpeningOptions& options = AsyncOpeningOptions());
+
+AsyncOpeningHandle OpenGraphNullRemovalDifferenceAsync(const Graph& g, unsigned int goalSuccessiveNullDifferences,
+                                                       const AsyncOpeningOptions& options = AsyncOpeningOptions());
+
+#endif
@@ -0,0 +1,609 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// This program measures the throughput of the opening implementations on synthetic trees.
+// Every case is run several times and the fastest run is reported. Where the kernel allows it,
+// the hardware cache misses of the opening are counted as well.
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Custom
+#include "CompactGraph.h"
+#include "CompressedGraph.h"
+#include "GraphOpeningTracking.h"
+#include "Helpers.h"
+#include "OpeningEngine.h"
+#include "OpeningResultHolder.h"
+#include "ParentArrayTree.h"
+#include "OpeningStatistics.h"
+#include "VertexOrdering.h"
+
+#ifdef __linux__
+// C
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Counts the hardware cache misses and cache references of the calling thread with perf_event_open.
+// It is not available on other systems, in most virtual machines, or if perf_event_paranoid forbids it.
+class CacheMissCounter
+{
+public:
+  CacheMissCounter() : MissesDescriptor(-1), ReferencesDescriptor(-1)
+  {
+#ifdef __linux__
+    MissesDescriptor = Open(PERF_COUNT_HW_CACHE_MISSES);
+    ReferencesDescriptor = Open(PERF_COUNT_HW_CACHE_REFERENCES);
+#endif
+  }
+
+  ~CacheMissCounter()
+  {
+#ifdef __linux__
+    if(MissesDescriptor >= 0)
+      {
+      close(MissesDescriptor);
+      }
+    if(ReferencesDescriptor >= 0)
+      {
+      close(ReferencesDescriptor);
+      }
+#endif
+  }
+
+  bool IsAvailable() const
+  {
+    return MissesDescriptor >= 0 && ReferencesDescriptor >= 0;
+  }
+
+  // Count the misses and references while 'function' runs. Returns false if the counters are not available.
+  template <typename TFunction>
+  bool Measure(TFunction function, uint64_t& misses, uint64_t& references)
+  {
+    if(!IsAvailable())
+      {
+      return false;
+      }
+#ifdef __linux__
+    ioctl(MissesDescriptor, PERF_EVENT_IOC_RESET, 0);
+    ioctl(ReferencesDescriptor, PERF_EVENT_IOC_RESET, 0);
+    ioctl(MissesDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+    ioctl(ReferencesDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+    function();
+    ioctl(MissesDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+    ioctl(ReferencesDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+    return read(MissesDescriptor, &misses, sizeof(misses)) == sizeof(misses) &&
+           read(ReferencesDescriptor, &references, sizeof(references)) == sizeof(references);
+#else
+    return false;
+#endif
+  }
+
+private:
+#ifdef __linux__
+  static int Open(const unsigned long long config)
+  {
+    perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+  }
+#endif
+
+  int MissesDescriptor;
+  int ReferencesDescriptor;
+};
+
+// A random tree in which most vertices continue a branch and the rest start a new one,
+// similar to the minimum spanning trees of contour points.
+static void CreateRandomTree(const unsigned int numberOfVertices, std::vector<uint32_t>& sources, std::vector<uint32_t>& targets)
+{
+  srand(0);
+  sources.clear();
+  targets.clear();
+  for(unsigned int v = 1; v < numberOfVertices; ++v)
+    {
+    unsigned int parent = (rand() % 3 == 0) ? rand() % v : v - 1;
+    sources.push_back(parent);
+    targets.push_back(v);
+    }
+}
+
+// Give the vertices random ids, as if they had been numbered in the order a scan found them.
+static void ShuffleVertexIds(const unsigned int numberOfVertices, std::vector<uint32_t>& sources, std::vector<uint32_t>& targets)
+{
+  std::vector<uint32_t> newIds(numberOfVertices);
+  for(unsigned int v = 0; v < numberOfVertices; ++v)
+    {
+    newIds[v] = v;
+    }
+  srand(1);
+  for(unsigned int v = numberOfVertices; v > 1; --v)
+    {
+    std::swap(newIds[v - 1], newIds[rand() % v]);
+    }
+  for(size_t i = 0; i < sources.size(); ++i)
+    {
+    sources[i] = newIds[sources[i]];
+    targets[i] = newIds[targets[i]];
+    }
+}
+
+// A hand-written fixed-iteration opening with a degree threshold of 1, used as the reference for the engine.
+static void OpenHandWritten(const CompactGraph& g, const unsigned int numberOfIterations, std::vector<bool>& keep)
+{
+  std::vector<uint32_t> degrees(g.NumberOfVertices);
+  std::vector<uint32_t> queued(g.NumberOfVertices, 0);
+  std::vector<bool> removed(g.NumberOfEdges, false);
+  std::vector<uint32_t> current;
+  std::vector<uint32_t> next;
+  std::vector<uint32_t> touched;
+  for(uint32_t v = 0; v < g.NumberOfVertices; ++v)
+    {
+    degrees[v] = g.Offsets[v + 1] - g.Offsets[v];
+    if(degrees[v] == 1)
+      {
+      queued[v] = 1;
+      current.push_back(v);
+      }
+    }
+
+  for(uint32_t round = 1; round <= numberOfIterations && !current.empty(); ++round)
+    {
+    next.clear();
+    touched.clear();
+    for(size_t i = 0; i < current.size(); ++i)
+      {
+      uint32_t v = current[i];
+      for(uint32_t slot = g.Offsets[v]; slot < g.Offsets[v + 1]; ++slot)
+        {
+        uint32_t edgeId = g.IncidentEdges[slot];
+        if(removed[edgeId])
+          {
+          continue;
+          }
+        uint32_t neighbor = g.Neighbors[slot];
+        removed[edgeId] = true;
+        degrees[v]--;
+        degrees[neighbor]--;
+        touched.push_back(neighbor);
+        if(queued[neighbor] == 0 && degrees[neighbor] == 1)
+          {
+          queued[neighbor] = round + 1;
+          next.push_back(neighbor);
+          }
+        }
+      }
+    current.clear();
+    for(size_t i = 0; i < next.size(); ++i)
+      {
+      if(degrees[next[i]] == 1)
+        {
+        current.push_back(next[i]);
+        }
+      }
+    if(round == numberOfIterations)
+      {
+      break;
+      }
+    if(current.empty())
+      {
+      touched.clear();
+      }
+    }
+
+  keep.resize(g.NumberOfEdges);
+  for(uint32_t edgeId = 0; edgeId < g.NumberOfEdges; ++edgeId)
+    {
+    keep[edgeId] = !removed[edgeId];
+    }
+
+  std::vector<uint32_t> visited(g.NumberOfVertices, 0);
+  for(uint32_t dilation = 1; dilation <= numberOfIterations && !touched.empty(); ++dilation)
+    {
+    next.clear();
+    current.clear();
+    for(size_t i = 0; i < touched.size(); ++i)
+      {
+      uint32_t v = touched[i];
+      if(visited[v] != dilation && degrees[v] == 1)
+        {
+        current.push_back(v);
+        }
+      visited[v] = dilation;
+      }
+    for(size_t i = 0; i < current.size(); ++i)
+      {
+      uint32_t v = current[i];
+      for(uint32_t slot = g.Offsets[v]; slot < g.Offsets[v + 1]; ++slot)
+        {
+        uint32_t edgeId = g.IncidentEdges[slot];
+        if(keep[edgeId])
+          {
+          continue;
+          }
+        keep[edgeId] = true;
+        degrees[v]++;
+        degrees[g.Neighbors[slot]]++;
+        next.push_back(g.Neighbors[slot]);
+        }
+      }
+    touched.swap(next);
+    }
+}
+
+// Discards everything written to std::cout while it exists, such as the edges printed by the tracking opening
+class SilenceOutput
+{
+public:
+  SilenceOutput() : Previous(std::cout.rdbuf(&Discard)) {}
+
+  ~SilenceOutput()
+  {
+    std::cout.rdbuf(Previous);
+  }
+
+private:
+  struct DiscardBuffer : public std::streambuf
+  {
+    int overflow(int c)
+    {
+      return traits_type::not_eof(c);
+    }
+  };
+
+  DiscardBuffer Discard;
+  std::streambuf* Previous;
+};
+
+// Run 'function' 'repetitions' times and return the fastest time in seconds
+template <typename TFunction>
+double TimeFastest(const unsigned int repetitions, TFunction function)
+{
+  double fastest = 0;
+  for(unsigned int i = 0; i < repetitions; ++i)
+    {
+    Timer timer;
+    function();
+    double seconds = timer.GetElapsedSeconds();
+    if(i == 0 || seconds < fastest)
+      {
+      fastest = seconds;
+      }
+    }
+  return fastest;
+}
+
+// Output the cache misses of one more run of 'function', if they can be counted
+template <typename TFunction>
+void OutputCacheMisses(CacheMissCounter& counter, const size_t numberOfEdges, TFunction function)
+{
+  uint64_t misses = 0;
+  uint64_t references = 0;
+  if(!counter.Measure(function, misses, references))
+    {
+    return;
+    }
+  std::cout << std::left << std::setw(40) << "  cache misses" << std::right << std::setw(12) << std::setprecision(2)
+            << static_cast<double>(misses) / numberOfEdges << " /edge" << std::setw(10) << std::setprecision(1)
+            << (references > 0 ? 100.0 * misses / references : 0.0) << " % of references" << std::endl;
+}
+
+static void OutputFootprint(const std::string& name, const size_t bytes, const size_t numberOfEdges)
+{
+  std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << std::fixed << std::setprecision(1)
+            << bytes / 1048576.0 << " MB" << std::setw(12) << std::setprecision(2)
+            << static_cast<double>(bytes) / numberOfEdges << " bytes/edge" << std::endl;
+}
+
+static void OutputResult(const std::string& name, const double seconds, const size_t numberOfEdges, const bool matches)
+{
+  std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << std::fixed << std::setprecision(4)
+            << seconds << " s" << std::setw(12) << std::setprecision(1) << numberOfEdges / seconds / 1e6 << " Medges/s"
+            << (matches ? "" : "   RESULT DIFFERS") << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int numberOfVertices = 2000000;
+  unsigned int numberOfIterations = 10;
+  unsigned int repetitions = 5;
+  if(argc > 1)
+    {
+    std::stringstream ss(argv[1]);
+    ss >> numberOfVertices;
+    }
+  if(argc > 2)
+    {
+    std::stringstream ss(argv[2]);
+    ss >> numberOfIterations;
+    }
+  if(argc > 3)
+    {
+    std::stringstream ss(argv[3]);
+    ss >> repetitions;
+    }
+
+  std::cout << "Vertices: " << numberOfVertices << " Iterations: " << numberOfIterations
+            << " Repetitions: " << repetitions << std::endl;
+
+  CacheMissCounter cacheMissCounter;
+  if(!cacheMissCounter.IsAvailable())
+    {
+    std::cout << "Cache misses can not be counted on this system" << std::endl;
+    }
+
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  CreateRandomTree(numberOfVertices, sources, targets);
+  EdgeArrays edges;
+  edges.Sources = sources.data();
+  edges.Targets = targets.data();
+  edges.NumberOfEdges = sources.size();
+
+  CompactGraph g;
+  double seconds = TimeFastest(repetitions, [&]() { g = CreateCompactGraph(edges); });
+  OutputResult("Build CompactGraph", seconds, edges.NumberOfEdges, true);
+
+  std::vector<bool> reference;
+  seconds = TimeFastest(repetitions, [&]() { OpenHandWritten(g, numberOfIterations, reference); });
+  OutputResult("Hand-written fixed loop", seconds, edges.NumberOfEdges, true);
+
+  {
+  std::vector<bool> keep;
+  OpeningEngine<CompactGraph, FixedIterations> engine;
+  NullObserver observer;
+  seconds = TimeFastest(repetitions, [&]() { engine.Open(g, FixedIterations(numberOfIterations), observer, keep); });
+  OutputResult("Engine fixed, no observer", seconds, edges.NumberOfEdges, keep == reference);
+  OutputCacheMisses(cacheMissCounter, edges.NumberOfEdges,
+                    [&]() { engine.Open(g, FixedIterations(numberOfIterations), observer, keep); });
+  }
+
+  {
+  std::vector<bool> keep;
+  OpeningEngine<CompactGraph, FixedIterations, NullObserver, uint32_t, BitmapFrontier> engine;
+  NullObserver observer;
+  seconds = TimeFastest(repetitions, [&]() { engine.Open(g, FixedIterations(numberOfIterations), observer, keep); });
+  OutputResult("Engine fixed, bitmap frontier", seconds, edges.NumberOfEdges, keep == reference);
+  }
+
+  {
+  std::vector<bool> keep;
+  OpeningEngine<CompactGraph, FixedIterations, StatisticsObserver> engine;
+  OpeningStatistics statistics;
+  StatisticsObserver observer(&statistics);
+  seconds = TimeFastest(repetitions, [&]() { engine.Open(g, FixedIterations(numberOfIterations), observer, keep); });
+  OutputResult("Engine fixed, statistics observer", seconds, edges.NumberOfEdges, keep == reference);
+  }
+
+  {
+  CompactGraph64 g64 = CreateCompactAdjacency<uint64_t>(edges);
+  std::vector<bool> keep;
+  OpeningEngine<CompactGraph64, FixedIterations> engine;
+  NullObserver observer;
+  seconds = TimeFastest(repetitions, [&]() { engine.Open(g64, FixedIterations(numberOfIterations), observer, keep); });
+  OutputResult("Engine fixed, 64-bit indices", seconds, edges.NumberOfEdges, keep == reference);
+  }
+
+  {
+  std::vector<bool> keep;
+  OpeningEngine<CompactGraph, NullRemovalDifference> engine;
+  NullObserver observer;
+  seconds = TimeFastest(repetitions, [&]() { engine.Open(g, NullRemovalDifference(3), observer, keep); });
+  std::stringstream name;
+  name << "Engine null difference (" << engine.GetNumberOfErosions() << " erosions)";
+  OutputResult(name.str(), seconds, edges.NumberOfEdges, true);
+  }
+
+  // The same tree with the vertex ids of a scan, opened as it is and after reordering it
+  {
+  std::vector<uint32_t> shuffledSources = sources;
+  std::vector<uint32_t> shuffledTargets = targets;
+  ShuffleVertexIds(numberOfVertices, shuffledSources, shuffledTargets);
+  EdgeArrays shuffledEdges;
+  shuffledEdges.Sources = shuffledSources.data();
+  shuffledEdges.Targets = shuffledTargets.data();
+  shuffledEdges.NumberOfEdges = shuffledSources.size();
+  CompactGraph shuffled = CreateCompactGraph(shuffledEdges, numberOfVertices);
+
+  std::vector<bool> keep;
+  OpeningEngine<CompactGraph, FixedIterations> engine;
+  NullObserver observer;
+  seconds = TimeFastest(repetitions, [&]() { engine.Open(shuffled, FixedIterations(numberOfIterations), observer, keep); });
+  OutputResult("Engine fixed, scan order ids", seconds, edges.NumberOfEdges, keep == reference);
+  OutputCacheMisses(cacheMissCounter, edges.NumberOfEdges,
+                    [&]() { engine.Open(shuffled, FixedIterations(numberOfIterations), observer, keep); });
+
+  GraphReordering reordering;
+  CompactGraph reordered;
+  seconds = TimeFastest(repetitions, [&]()
+    {
+    reordering = ComputeReordering(shuffled);
+    reordered = ReorderCompactGraph(shuffled, reordering);
+    });
+  OutputResult("Reorder scan order ids", seconds, edges.NumberOfEdges, true);
+
+  seconds = TimeFastest(repetitions, [&]() { engine.Open(reordered, FixedIterations(numberOfIterations), observer, keep); });
+  OutputResult("Engine fixed, reordered ids", seconds, edges.NumberOfEdges,
+               MapKeepMaskBack(keep, reordering) == reference);
+  OutputCacheMisses(cacheMissCounter, edges.NumberOfEdges,
+                    [&]() { engine.Open(reordered, FixedIterations(numberOfIterations), observer, keep); });
+
+  // The reordered graph compressed, trading decoding time for memory
+  CompressedGraph compressed;
+  seconds = TimeFastest(repetitions, [&]() { compressed = CompressCompactGraph(reordered); });
+  OutputResult("Compress reordered graph", seconds, edges.NumberOfEdges, true);
+
+  OpeningEngine<CompressedGraph, FixedIterations> compressedEngine;
+  seconds = TimeFastest(repetitions, [&]()
+    {
+    compressedEngine.Open(compressed, FixedIterations(numberOfIterations), observer, keep);
+    });
+  OutputResult("Engine fixed, compressed reordered", seconds, edges.NumberOfEdges,
+               MapKeepMaskBack(keep, reordering) == reference);
+  OutputFootprint("  CompactGraph", GetAllocatedBytes(reordered), edges.NumberOfEdges);
+  OutputFootprint("  CompressedGraph", GetAllocatedBytes(compressed), edges.NumberOfEdges);
+  }
+
+  // The same tree stored as a parent array, which OpenEdgeArrays* pick for forests
+  {
+  ParentArrayTree tree;
+  seconds = TimeFastest(repetitions, [&]() { CreateParentArrayTree(edges, tree); });
+  OutputResult("Build ParentArrayTree", seconds, edges.NumberOfEdges, true);
+
+  std::vector<bool> keep;
+  OpeningEngine<ParentArrayTree, FixedIterations> engine;
+  NullObserver observer;
+  seconds = TimeFastest(repetitions, [&]() { engine.Open(tree, FixedIterations(numberOfIterations), observer, keep); });
+  OutputResult("Engine fixed, parent-array tree", seconds, edges.NumberOfEdges,
+               MapKeepMaskBack(keep, tree, edges) == reference);
+  OutputFootprint("  CompactGraph", GetAllocatedBytes(g), edges.NumberOfEdges);
+  OutputFootprint("  ParentArrayTree", GetAllocatedBytes(tree), edges.NumberOfEdges);
+  }
+
+  // A star, like a cluster of noise around one point. Its first erosion removes every edge of the hub.
+  {
+  const unsigned int numberOfLeaves = numberOfVertices / 10;
+  Graph star(numberOfLeaves + 1);
+  std::vector<uint32_t> starSources(numberOfLeaves, 0);
+  std::vector<uint32_t> starTargets(numberOfLeaves);
+  for(unsigned int leaf = 1; leaf <= numberOfLeaves; ++leaf)
+    {
+    boost::add_edge(0, leaf, star);
+    starTargets[leaf - 1] = leaf;
+    }
+
+  // The whole opening is timed, including building the tracking workspace and the result
+  Graph opened;
+  seconds = TimeFastest(repetitions, [&]()
+    {
+    SilenceOutput silence;
+    opened = OpenGraphFixedTracking(star, 2);
+    });
+  std::stringstream name;
+  name << "Tracking fixed, star of " << numberOfLeaves;
+  OutputResult(name.str(), seconds, numberOfLeaves, boost::num_edges(opened) == 0);
+
+  EdgeArrays starEdges = {starSources.data(), starTargets.data(), numberOfLeaves};
+  CompactGraph compactStar = CreateCompactGraph(starEdges, numberOfLeaves + 1);
+  std::vector<bool> keep;
+  OpeningEngine<CompactGraph, FixedIterations> engine;
+  NullObserver observer;
+  seconds = TimeFastest(repetitions, [&]() { engine.Open(compactStar, FixedIterations(2), observer, keep); });
+  OutputResult("Engine fixed, star", seconds, numberOfLeaves, std::count(keep.begin(), keep.end(), true) == 0);
+  }
+
+  // Reader threads checking the current opening while one thread keeps publishing new ones. A reader
+  // which saw a freed snapshot would find a keep-mask which does not match its edge count.
+  {
+  const unsigned int numberOfReaders = 8;
+  const unsigned int numberOfPublishes = 100;
+  std::vector<uint32_t> smallSources;
+  std::vector<uint32_t> smallTargets;
+  CreateRandomTree(std::max(2u, numberOfVertices / 20), smallSources, smallTargets);
+  EdgeArrays smallEdges = {smallSources.data(), smallTargets.data(), smallSources.size()};
+  CompactGraph small = CreateCompactGraph(smallEdges);
+
+  OpeningResultHolder holder(numberOfReaders);
+  std::atomic<bool> done(false);
+  std::atomic<size_t> numberOfReads(0);
+  std::atomic<size_t> numberOfInconsistentReads(0);
+  std::atomic<size_t> numberOfBackwardVersions(0);
+  std::vector<std::thread> readers;
+  for(unsigned int i = 0; i < numberOfReaders; ++i)
+    {
+    readers.push_back(std::thread([&]()
+      {
+      OpeningResultHolder::Reader reader(holder);
+      uint64_t lastVersion = 0;
+      size_t reads = 0;
+      while(!done)
+        {
+        const OpeningSnapshot* snapshot = reader.Acquire();
+        if(snapshot)
+          {
+          if(snapshot->Version < lastVersion)
+            {
+            numberOfBackwardVersions++;
+            }
+          if(static_cast<size_t>(std::count(snapshot->Keep.begin(), snapshot->Keep.end(), true)) != snapshot->NumberOfKeptEdges)
+            {
+            numberOfInconsistentReads++;
+            }
+          lastVersion = snapshot->Version;
+          reads++;
+          }
+        reader.Release();
+        }
+      numberOfReads += reads;
+      }));
+    }
+
+  Timer timer;
+  OpeningEngine<CompactGraph, FixedIterations> engine;
+  NullObserver observer;
+  for(unsigned int i = 0; i < numberOfPublishes; ++i)
+    {
+    std::unique_ptr<OpeningSnapshot> snapshot(new OpeningSnapshot);
+    snapshot->Parameter = 1 + i % numberOfIterations;
+    engine.Open(small, FixedIterations(snapshot->Parameter), observer, snapshot->Keep);
+    snapshot->NumberOfErosions = engine.GetNumberOfErosions();
+    snapshot->NumberOfKeptEdges = std::count(snapshot->Keep.begin(), snapshot->Keep.end(), true);
+    holder.Publish(std::move(snapshot));
+    }
+  done = true;
+  for(unsigned int i = 0; i < readers.size(); ++i)
+    {
+    readers[i].join();
+    }
+  seconds = timer.GetElapsedSeconds();
+
+  std::stringstream name;
+  name << "Snapshot reads, " << numberOfReaders << " readers";
+  std::cout << std::left << std::setw(40) << name.str() << std::right << std::setw(12) << std::setprecision(1)
+            << numberOfReads / seconds << " reads/s, " << numberOfPublishes / seconds << " publishes/s, "
+            << numberOfInconsistentReads << " inconsistent, " << numberOfBackwardVersions << " went back, "
+            << holder.GetNumberOfRetiredSnapshots() << " not freed" << std::endl;
+
+  // This is the only check of OpeningResultHolder, so it has to fail the run
+  if(numberOfInconsistentReads > 0 || numberOfBackwardVersions > 0)
+    {
+    std::cerr << "OpeningResultHolder handed out an inconsistent snapshot" << std::endl;
+    return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
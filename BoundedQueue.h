@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+// STL
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// A first-in first-out queue between threads which holds at most 'capacity' items, so a fast
+// producer waits for a slow consumer instead of filling up the memory.
+template <typename T>
+class BoundedQueue
+{
+public:
+  explicit BoundedQueue(const size_t capacity) : Capacity(capacity), Closed(false) {}
+
+  // Wait until there is room, then add 'item'.
+  void Push(T item)
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+    NotFull.wait(lock, [this]() { return Items.size() < Capacity; });
+    Items.push_back(std::move(item));
+    NotEmpty.notify_one();
+  }
+
+  // Wait for an item and move it into 'item'. Returns false once the queue is closed and empty.
+  bool Pop(T& item)
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+    NotEmpty.wait(lock, [this]() { return !Items.empty() || Closed; });
+    if(Items.empty())
+      {
+      return false;
+      }
+    item = std::move(Items.front());
+    Items.pop_front();
+    NotFull.notify_one();
+    return true;
+  }
+
+  // No more items will be pushed. The consumers finish the remaining items and then stop.
+  void Close()
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    Closed = true;
+    NotEmpty.notify_all();
+  }
+
+private:
+  size_t Capacity;
+  bool Closed;
+  std::deque<T> Items;
+  std::mutex Mutex;
+  std::condition_variable NotEmpty;
+  std::condition_variable NotFull;
+};
+
+#endif
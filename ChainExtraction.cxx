@@ -0,0 +1,116 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "ChainExtraction.h"
+
+Chains ExtractChains(const CompactGraph& g, const std::vector<bool>& keep)
+{
+  Chains chains;
+  chains.Offsets.push_back(0);
+
+  std::vector<uint32_t> degrees(g.NumberOfVertices, 0);
+  for(uint32_t v = 0; v < g.NumberOfVertices; ++v)
+    {
+    g.ForEachNeighbor(v, [&](const uint32_t, const uint32_t edgeId)
+      {
+      if(keep[edgeId])
+        {
+        degrees[v]++;
+        }
+      });
+    }
+
+  std::vector<bool> used(g.NumberOfEdges, false);
+
+  // Follow the chain leaving 'start' along 'edgeId' until a vertex which does not have two neighbors,
+  // or until it comes back to 'start'
+  auto walk = [&](const uint32_t start, uint32_t edgeId, uint32_t next)
+    {
+    chains.Vertices.push_back(start);
+    while(true)
+      {
+      used[edgeId] = true;
+      chains.Vertices.push_back(next);
+      if(degrees[next] != 2 || next == start)
+        {
+        break;
+        }
+      const uint32_t v = next;
+      g.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t candidate)
+        {
+        if(keep[candidate] && !used[candidate] && next == v)
+          {
+          edgeId = candidate;
+          next = neighbor;
+          }
+        });
+      if(next == v)
+        {
+        // Every edge of 'v' has been used
+        break;
+        }
+      }
+    chains.Offsets.push_back(chains.Vertices.size());
+    };
+
+  // Chains which end at end points or junctions
+  for(uint32_t v = 0; v < g.NumberOfVertices; ++v)
+    {
+    if(degrees[v] == 0 || degrees[v] == 2)
+      {
+      continue;
+      }
+    g.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t edgeId)
+      {
+      if(keep[edgeId] && !used[edgeId])
+        {
+        walk(v, edgeId, neighbor);
+        }
+      });
+    }
+
+  // Whatever is left are cycles of vertices with two neighbors
+  for(uint32_t v = 0; v < g.NumberOfVertices; ++v)
+    {
+    if(degrees[v] != 2)
+      {
+      continue;
+      }
+    g.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t edgeId)
+      {
+      if(keep[edgeId] && !used[edgeId])
+        {
+        walk(v, edgeId, neighbor);
+        }
+      });
+    }
+
+  return chains;
+}
+
+void GatherChainPoints(const PointCloud& points, Chains& chains)
+{
+  chains.Points.resize(3 * chains.Vertices.size());
+  for(size_t i = 0; i < chains.Vertices.size(); ++i)
+    {
+    for(unsigned int d = 0; d < 3; ++d)
+      {
+      chains.Points[3 * i + d] = points.Coordinates[3 * chains.Vertices[i] + d];
+      }
+    }
+}
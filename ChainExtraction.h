@@ -0,0 +1,57 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef CHAINEXTRACTION_H
+#define CHAINEXTRACTION_H
+
+// STL
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "CompactGraph.h"
+#include "EuclideanMST.h"
+
+// The opened graph split into chains: maximal paths whose inner vertices have exactly two neighbors.
+// A chain runs from an end point or junction to an end point or junction, or around a cycle without
+// junctions, in which case its first vertex is repeated at its end.
+struct Chains
+{
+  // The vertices of chain c are [Offsets[c], Offsets[c+1]) of Vertices, in order along the chain.
+  std::vector<uint32_t> Vertices;
+  std::vector<uint32_t> Offsets;
+
+  // If gathered, the x y z coordinates of every entry of Vertices.
+  std::vector<float> Points;
+
+  size_t GetNumberOfChains() const
+  {
+    return Offsets.size() - 1;
+  }
+};
+
+// Split the edges of 'g' which are set in 'keep' into chains in one pass over the graph. Every kept
+// edge is in exactly one chain.
+Chains ExtractChains(const CompactGraph& g, const std::vector<bool>& keep);
+
+// Fill in chains.Points from the coordinates of the vertices, so the chains can be read in order.
+void GatherChainPoints(const PointCloud& points, Chains& chains);
+
+#endif
@@ -0,0 +1,348 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "CompactGraph.h"
+#include "Helpers.h"
+#include "Parallel.h"
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+CompactGraph CreateCompactGraph(const Graph& g)
+{
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  sources.reserve(boost::num_edges(g));
+  targets.reserve(boost::num_edges(g));
+
+  std::pair<Graph::edge_iterator, Graph::edge_iterator> edgeIteratorRange = boost::edges(g);
+  for(Graph::edge_iterator edgeIterator = edgeIteratorRange.first; edgeIterator != edgeIteratorRange.second; ++edgeIterator)
+    {
+    sources.push_back(boost::source(*edgeIterator, g));
+    targets.push_back(boost::target(*edgeIterator, g));
+    }
+
+  EdgeArrays edges;
+  edges.Sources = sources.data();
+  edges.Targets = targets.data();
+  edges.NumberOfEdges = sources.size();
+
+  // Pass the number of vertices, as vertices without edges still have to be present
+  return CreateCompactGraph(edges, boost::num_vertices(g));
+}
+
+template <typename TIndex>
+CompactAdjacency<TIndex> CreateCompactAdjacency(const EdgeArrays& edges, TIndex numberOfVertices)
+{
+  CompactAdjacency<TIndex> g;
+  g.NumberOfEdges = edges.NumberOfEdges;
+
+  // Find the number of vertices from the largest id
+  if(numberOfVertices == 0)
+    {
+    std::vector<TIndex> largestIds(GetNumberOfThreads(edges.NumberOfEdges), 0);
+    ParallelFor(0, edges.NumberOfEdges, [&](size_t begin, size_t end, unsigned int threadId)
+      {
+      for(size_t edgeId = begin; edgeId < end; ++edgeId)
+        {
+        largestIds[threadId] = std::max<TIndex>(largestIds[threadId], static_cast<TIndex>(edges.Sources[edgeId]) + 1);
+        largestIds[threadId] = std::max<TIndex>(largestIds[threadId], static_cast<TIndex>(edges.Targets[edgeId]) + 1);
+        }
+      });
+    numberOfVertices = *std::max_element(largestIds.begin(), largestIds.end());
+    }
+  g.NumberOfVertices = numberOfVertices;
+
+  // Count the degree of every vertex
+  std::unique_ptr<std::atomic<TIndex>[]> counters(new std::atomic<TIndex>[numberOfVertices]);
+  ParallelFor(0, numberOfVertices, [&](size_t begin, size_t end, unsigned int)
+    {
+    for(size_t v = begin; v < end; ++v)
+      {
+      counters[v].store(0, std::memory_order_relaxed);
+      }
+    });
+  ParallelFor(0, edges.NumberOfEdges, [&](size_t begin, size_t end, unsigned int)
+    {
+    for(size_t edgeId = begin; edgeId < end; ++edgeId)
+      {
+      counters[edges.Sources[edgeId]].fetch_add(1, std::memory_order_relaxed);
+      counters[edges.Targets[edgeId]].fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+
+  // Prefix sum to get the start of every vertex's neighbor list. The counters are reused
+  // as the next free slot of every vertex.
+  g.Offsets.resize(numberOfVertices + 1);
+  g.Offsets[0] = 0;
+  for(TIndex v = 0; v < numberOfVertices; ++v)
+    {
+    g.Offsets[v + 1] = g.Offsets[v] + counters[v].load(std::memory_order_relaxed);
+    counters[v].store(g.Offsets[v], std::memory_order_relaxed);
+    }
+
+  // Scatter the edges into their slots
+  g.Neighbors.resize(g.Offsets[numberOfVertices]);
+  g.IncidentEdges.resize(g.Offsets[numberOfVertices]);
+  ParallelFor(0, edges.NumberOfEdges, [&](size_t begin, size_t end, unsigned int)
+    {
+    for(size_t edgeId = begin; edgeId < end; ++edgeId)
+      {
+      TIndex source = edges.Sources[edgeId];
+      TIndex target = edges.Targets[edgeId];
+
+      TIndex slot = counters[source].fetch_add(1, std::memory_order_relaxed);
+      g.Neighbors[slot] = target;
+      g.IncidentEdges[slot] = edgeId;
+
+      slot = counters[target].fetch_add(1, std::memory_order_relaxed);
+      g.Neighbors[slot] = source;
+      g.IncidentEdges[slot] = edgeId;
+      }
+    });
+
+  // With several threads the slots of a vertex are filled in an arbitrary order. Sort them by edge id
+  // so the result does not depend on the number of threads.
+  if(GetNumberOfThreads(edges.NumberOfEdges) > 1)
+    {
+    ParallelFor(0, numberOfVertices, [&](size_t begin, size_t end, unsigned int)
+      {
+      std::vector<std::pair<TIndex, TIndex> > slots;
+      for(size_t v = begin; v < end; ++v)
+        {
+        TIndex first = g.Offsets[v];
+        TIndex last = g.Offsets[v + 1];
+        if(std::is_sorted(g.IncidentEdges.begin() + first, g.IncidentEdges.begin() + last))
+          {
+          continue;
+          }
+        slots.clear();
+        for(TIndex slot = first; slot < last; ++slot)
+          {
+          slots.push_back(std::make_pair(g.IncidentEdges[slot], g.Neighbors[slot]));
+          }
+        std::sort(slots.begin(), slots.end());
+        for(TIndex slot = first; slot < last; ++slot)
+          {
+          g.IncidentEdges[slot] = slots[slot - first].first;
+          g.Neighbors[slot] = slots[slot - first].second;
+          }
+        }
+      });
+    }
+
+  return g;
+}
+
+template CompactAdjacency<uint32_t> CreateCompactAdjacency<uint32_t>(const EdgeArrays& edges, uint32_t numberOfVertices);
+template CompactAdjacency<uint64_t> CreateCompactAdjacency<uint64_t>(const EdgeArrays& edges, uint64_t numberOfVertices);
+
+CompactGraph CreateCompactGraph(const EdgeArrays& edges, unsigned int numberOfVertices)
+{
+  return CreateCompactAdjacency<uint32_t>(edges, numberOfVertices);
+}
+
+Graph CreateGraphFromKeepMask(const Graph& g, const std::vector<bool>& keep)
+{
+  Graph graph(boost::num_vertices(g));
+
+  unsigned int edgeId = 0;
+  std::pair<Graph::edge_iterator, Graph::edge_iterator> edgeIteratorRange = boost::edges(g);
+  for(Graph::edge_iterator edgeIterator = edgeIteratorRange.first; edgeIterator != edgeIteratorRange.second; ++edgeIterator)
+    {
+    if(keep[edgeId])
+      {
+      std::pair<Graph::edge_descriptor, bool> addedEdge =
+        boost::add_edge(boost::source(*edgeIterator, g), boost::target(*edgeIterator, g), graph);
+      graph[addedEdge.first].visible = true;
+      }
+    edgeId++;
+    }
+
+  IndexEdges(graph);
+  return graph;
+}
+
+const uint32_t CleanedEdges::RemovedEdge;
+
+CleanedEdges CleanEdgeArrays(const EdgeArrays& edges)
+{
+  CleanedEdges cleanedEdges;
+  const size_t numberOfEdges = edges.NumberOfEdges;
+
+  // Sort the edges which are not self loops by (smaller id, larger id) and then by edge id, so the
+  // copies of an edge are next to each other with the first one in front
+  std::vector<size_t> numberOfSelfLoops(GetNumberOfThreads(numberOfEdges), 0);
+  ParallelFor(0, numberOfEdges, [&](size_t begin, size_t end, unsigned int threadId)
+    {
+    for(size_t edgeId = begin; edgeId < end; ++edgeId)
+      {
+      numberOfSelfLoops[threadId] += (edges.Sources[edgeId] == edges.Targets[edgeId]);
+      }
+    });
+  for(size_t i = 0; i < numberOfSelfLoops.size(); ++i)
+    {
+    cleanedEdges.NumberOfSelfLoops += numberOfSelfLoops[i];
+    }
+
+  std::vector<std::pair<uint64_t, uint32_t> > keys;
+  keys.reserve(numberOfEdges - cleanedEdges.NumberOfSelfLoops);
+  for(size_t edgeId = 0; edgeId < numberOfEdges; ++edgeId)
+    {
+    const uint64_t source = edges.Sources[edgeId];
+    const uint64_t target = edges.Targets[edgeId];
+    if(source != target)
+      {
+      keys.push_back(std::make_pair((std::min(source, target) << 32) | std::max(source, target), static_cast<uint32_t>(edgeId)));
+      }
+    }
+  ParallelSort(keys);
+
+  // The first copy of every edge, or RemovedEdge for self loops
+  std::vector<uint32_t>& firstCopies = cleanedEdges.NewEdgeIds;
+  firstCopies.assign(numberOfEdges, CleanedEdges::RemovedEdge);
+  ParallelFor(0, keys.size(), [&](size_t begin, size_t end, unsigned int)
+    {
+    // A run of copies may have started in the previous chunk
+    size_t first = begin;
+    while(first > 0 && keys[first - 1].first == keys[begin].first)
+      {
+      first--;
+      }
+    for(size_t i = begin; i < end; ++i)
+      {
+      if(keys[i].first != keys[first].first)
+        {
+        first = i;
+        }
+      firstCopies[keys[i].second] = keys[first].second;
+      }
+    });
+
+  // Number the first copies in input order: count them per chunk, then number them from the chunk's offset
+  const unsigned int numberOfChunks = GetNumberOfThreads(numberOfEdges);
+  std::vector<size_t> chunkOffsets(numberOfChunks + 1, 0);
+  ParallelFor(0, numberOfEdges, [&](size_t begin, size_t end, unsigned int threadId)
+    {
+    for(size_t edgeId = begin; edgeId < end; ++edgeId)
+      {
+      chunkOffsets[threadId + 1] += (firstCopies[edgeId] == edgeId);
+      }
+    });
+  for(unsigned int chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+    chunkOffsets[chunk + 1] += chunkOffsets[chunk];
+    }
+  const size_t numberOfRemainingEdges = chunkOffsets[numberOfChunks];
+  cleanedEdges.NumberOfDuplicates = numberOfEdges - cleanedEdges.NumberOfSelfLoops - numberOfRemainingEdges;
+
+  cleanedEdges.Sources.resize(numberOfRemainingEdges);
+  cleanedEdges.Targets.resize(numberOfRemainingEdges);
+  std::vector<uint32_t> newIds(numberOfEdges);
+  ParallelFor(0, numberOfEdges, [&](size_t begin, size_t end, unsigned int threadId)
+    {
+    size_t newEdgeId = chunkOffsets[threadId];
+    for(size_t edgeId = begin; edgeId < end; ++edgeId)
+      {
+      if(firstCopies[edgeId] != edgeId)
+        {
+        continue;
+        }
+      newIds[edgeId] = newEdgeId;
+      cleanedEdges.Sources[newEdgeId] = std::min(edges.Sources[edgeId], edges.Targets[edgeId]);
+      cleanedEdges.Targets[newEdgeId] = std::max(edges.Sources[edgeId], edges.Targets[edgeId]);
+      newEdgeId++;
+      }
+    });
+
+  // Every copy gets the new id of its first copy
+  ParallelFor(0, numberOfEdges, [&](size_t begin, size_t end, unsigned int)
+    {
+    for(size_t edgeId = begin; edgeId < end; ++edgeId)
+      {
+      if(firstCopies[edgeId] != CleanedEdges::RemovedEdge)
+        {
+        firstCopies[edgeId] = newIds[firstCopies[edgeId]];
+        }
+      }
+    });
+
+  return cleanedEdges;
+}
+
+std::vector<bool> MapKeepMaskBack(const std::vector<bool>& keep, const CleanedEdges& cleanedEdges)
+{
+  std::vector<bool> originalKeep(cleanedEdges.NewEdgeIds.size(), false);
+  for(size_t edgeId = 0; edgeId < cleanedEdges.NewEdgeIds.size(); ++edgeId)
+    {
+    if(cleanedEdges.NewEdgeIds[edgeId] != CleanedEdges::RemovedEdge)
+      {
+      originalKeep[edgeId] = keep[cleanedEdges.NewEdgeIds[edgeId]];
+      }
+    }
+  return originalKeep;
+}
+
+size_t CleanGraph(Graph& g)
+{
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  sources.reserve(boost::num_edges(g));
+  targets.reserve(boost::num_edges(g));
+  std::pair<Graph::edge_iterator, Graph::edge_iterator> edgeIteratorRange = boost::edges(g);
+  for(Graph::edge_iterator edgeIterator = edgeIteratorRange.first; edgeIterator != edgeIteratorRange.second; ++edgeIterator)
+    {
+    sources.push_back(boost::source(*edgeIterator, g));
+    targets.push_back(boost::target(*edgeIterator, g));
+    }
+  EdgeArrays edges = {sources.data(), targets.data(), sources.size()};
+  CleanedEdges cleanedEdges = CleanEdgeArrays(edges);
+  if(cleanedEdges.GetNumberOfRemovedEdges() == 0)
+    {
+    return 0;
+    }
+
+  // The first copies are numbered in input order, so edge i is a first copy if its new id is the next one
+  std::vector<bool> keep(sources.size(), false);
+  uint32_t nextEdgeId = 0;
+  for(size_t edgeId = 0; edgeId < sources.size(); ++edgeId)
+    {
+    if(cleanedEdges.NewEdgeIds[edgeId] == nextEdgeId)
+      {
+      keep[edgeId] = true;
+      nextEdgeId++;
+      }
+    }
+
+  Graph cleanedGraph(boost::num_vertices(g));
+  size_t edgeId = 0;
+  for(Graph::edge_iterator edgeIterator = edgeIteratorRange.first; edgeIterator != edgeIteratorRange.second; ++edgeIterator)
+    {
+    if(keep[edgeId])
+      {
+      boost::add_edge(boost::source(*edgeIterator, g), boost::target(*edgeIterator, g), g[*edgeIterator], cleanedGraph);
+      }
+    edgeId++;
+    }
+  g.swap(cleanedGraph);
+  IndexEdges(g);
+  return cleanedEdges.GetNumberOfRemovedEdges();
+}
@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+
+// STL
+#include <cstddef>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "Types.h"
+
+// A view of caller-owned edge arrays. Edge i connects Sources[i] and Targets[i].
+// The arrays are only read, never copied.
+struct EdgeArrays
+{
+  const uint32_t* Sources;
+  const uint32_t* Targets;
+  size_t NumberOfEdges;
+};
+
+// A read-only compressed sparse row (CSR) adjacency of a graph. Edges are identified by their position
+// in the input (boost::edges() of a Graph, or the index into EdgeArrays), so a per-edge result
+// (such as a keep-mask) can be mapped back onto the original edges. TIndex must be wide enough
+// to hold twice the number of edges.
+template <typename TIndex>
+struct CompactAdjacency
+{
+  typedef TIndex IndexType;
+
+  TIndex NumberOfVertices;
+  TIndex NumberOfEdges;
+
+  // The neighbors of vertex v (and the ids of the edges leading to them) are stored
+  // in [Offsets[v], Offsets[v+1]) of Neighbors and IncidentEdges, in increasing edge id order.
+  std::vector<TIndex> Offsets;
+  std::vector<TIndex> Neighbors;
+  std::vector<TIndex> IncidentEdges;
+
+  TIndex Degree(const TIndex v) const
+  {
+    return Offsets[v + 1] - Offsets[v];
+  }
+
+  // Call visitor(neighbor, edgeId) for every edge of v.
+  template <typename TVisitor>
+  void ForEachNeighbor(const TIndex v, TVisitor visitor) const
+  {
+    for(TIndex slot = Offsets[v]; slot < Offsets[v + 1]; ++slot)
+      {
+      visitor(Neighbors[slot], IncidentEdges[slot]);
+      }
+  }
+};
+
+typedef CompactAdjacency<uint32_t> CompactGraph;
+
+// For graphs with more than 2^31 edges.
+typedef CompactAdjacency<uint64_t> CompactGraph64;
+
+// The number of bytes allocated by the adjacency of a CompactAdjacency.
+template <typename TIndex>
+size_t GetAllocatedBytes(const CompactAdjacency<TIndex>& g)
+{
+  return (g.Offsets.capacity() + g.Neighbors.capacity() + g.IncidentEdges.capacity()) * sizeof(TIndex);
+}
+
+// Create a CompactGraph with the same vertices and edges as 'g'.
+CompactGraph CreateCompactGraph(const Graph& g);
+
+// Create a CompactAdjacency directly from edge arrays with a parallel counting sort. If 'numberOfVertices'
+// is 0 it is determined from the largest vertex id in 'edges'. This is instantiated for uint32_t and uint64_t.
+template <typename TIndex>
+CompactAdjacency<TIndex> CreateCompactAdjacency(const EdgeArrays& edges, TIndex numberOfVertices = 0);
+
+// Create a CompactGraph directly from edge arrays, see CreateCompactAdjacency.
+CompactGraph CreateCompactGraph(const EdgeArrays& edges, unsigned int numberOfVertices = 0);
+
+// The edges left after removing the self loops and duplicate edges of an edge list, see CleanEdgeArrays.
+struct CleanedEdges
+{
+  CleanedEdges() : NumberOfSelfLoops(0), NumberOfDuplicates(0) {}
+
+  // NewEdgeIds of a self loop
+  static const uint32_t RemovedEdge = 0xffffffff;
+
+  // The remaining edges as (smaller id, larger id), in the order of their first occurrence in the input
+  std::vector<uint32_t> Sources;
+  std::vector<uint32_t> Targets;
+
+  // The id of every input edge in Sources/Targets. All copies of an edge have the id of the first one.
+  std::vector<uint32_t> NewEdgeIds;
+
+  size_t NumberOfSelfLoops;
+  size_t NumberOfDuplicates;
+
+  size_t GetNumberOfRemovedEdges() const
+  {
+    return NumberOfSelfLoops + NumberOfDuplicates;
+  }
+
+  EdgeArrays GetEdgeArrays() const
+  {
+    EdgeArrays edges = {Sources.data(), Targets.data(), Sources.size()};
+    return edges;
+  }
+};
+
+// Remove the self loops and all but the first copy of every edge (in either direction) with a parallel sort.
+// A duplicated edge at a leaf makes it look like a vertex of degree 2, so the leaf is never eroded.
+CleanedEdges CleanEdgeArrays(const EdgeArrays& edges);
+
+// Map a keep-mask of the cleaned edges back onto the input edges. Every copy of an edge is kept if the
+// edge is, and self loops are not kept.
+std::vector<bool> MapKeepMaskBack(const std::vector<bool>& keep, const CleanedEdges& cleanedEdges);
+
+// Remove the self loops and all but the first copy of every edge from 'g', keeping the properties of the
+// remaining edges, and index the edges again (see IndexEdges). Returns the number of removed edges.
+size_t CleanGraph(Graph& g);
+
+// Create a Graph containing all of the vertices of 'g' and only the edges which are set in 'keep'.
+// 'keep' is indexed in the order of boost::edges(g). The edges of the new graph are indexed (see IndexEdges).
+Graph CreateGraphFromKeepMask(const Graph& g, const std::vector<bool>& keep);
+
+#endif
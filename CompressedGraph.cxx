@@ -0,0 +1,82 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "CompressedGraph.h"
+
+static void WriteVarint(uint32_t value, std::vector<uint8_t>& data)
+{
+  while(value >= 0x80)
+    {
+    data.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+    }
+  data.push_back(static_cast<uint8_t>(value));
+}
+
+static uint32_t Zigzag(const uint32_t difference)
+{
+  return (difference << 1) ^ (0u - (difference >> 31));
+}
+
+size_t GetAllocatedBytes(const CompressedGraph& g)
+{
+  return g.Data.capacity() + g.BlockOffsets.capacity() * sizeof(uint64_t) + g.VertexOffsets.capacity() * sizeof(uint8_t) +
+         g.LargeOffsets.capacity() * sizeof(std::pair<uint32_t, uint64_t>);
+}
+
+CompressedGraph CompressCompactGraph(const CompactGraph& g)
+{
+  CompressedGraph compressed;
+  compressed.NumberOfVertices = g.NumberOfVertices;
+  compressed.NumberOfEdges = g.NumberOfEdges;
+  compressed.VertexOffsets.resize(g.NumberOfVertices);
+  compressed.BlockOffsets.reserve((g.NumberOfVertices + CompressedGraph::BlockSize - 1) / CompressedGraph::BlockSize);
+
+  // Most lists of a tree take a few bytes
+  compressed.Data.reserve(static_cast<size_t>(g.NumberOfVertices) * 6);
+
+  for(uint32_t v = 0; v < g.NumberOfVertices; ++v)
+    {
+    if(v % CompressedGraph::BlockSize == 0)
+      {
+      compressed.BlockOffsets.push_back(compressed.Data.size());
+      }
+    uint64_t offset = compressed.Data.size() - compressed.BlockOffsets.back();
+    if(offset < CompressedGraph::LargeOffset)
+      {
+      compressed.VertexOffsets[v] = static_cast<uint8_t>(offset);
+      }
+    else
+      {
+      compressed.VertexOffsets[v] = CompressedGraph::LargeOffset;
+      compressed.LargeOffsets.push_back(std::make_pair(v, static_cast<uint64_t>(compressed.Data.size())));
+      }
+
+    uint32_t previousEdgeId = v;
+    bool first = true;
+    g.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t edgeId)
+      {
+      WriteVarint(Zigzag(neighbor - v), compressed.Data);
+      WriteVarint(first ? Zigzag(edgeId - v) : edgeId - previousEdgeId, compressed.Data);
+      previousEdgeId = edgeId;
+      first = false;
+      });
+    }
+  compressed.Data.shrink_to_fit();
+  return compressed;
+}
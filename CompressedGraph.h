@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef COMPRESSEDGRAPH_H
+#define COMPRESSEDGRAPH_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "CompactGraph.h"
+
+// A read-only adjacency which stores the edges of every vertex as variable length integers (7 bits per byte,
+// the high bit set on all but the last byte), so it takes a fraction of the memory of a CompactGraph.
+// The list of vertex v holds one (neighbor, edge id) pair per edge in increasing edge id order: the neighbor
+// as the zigzag-encoded difference to v, and the edge id as the zigzag-encoded difference to v for the first
+// edge and the difference to the previous edge id for the others. A list ends where the next one starts,
+// so the degree is not stored. The differences are small when the ids are local, so compress a graph after
+// reordering it (see VertexOrdering.h). It has the interface of a CompactAdjacency, so an OpeningEngine
+// decodes it on the fly.
+struct CompressedGraph
+{
+  typedef uint32_t IndexType;
+
+  // The lists of the vertices are found in two steps: every BlockSize vertices the position of the list of
+  // the first vertex of the block is stored in BlockOffsets, and for every vertex its position relative to
+  // that in a single byte of VertexOffsets. A relative position which does not fit in a byte (in trees, only
+  // after a vertex of high degree) is LargeOffset, and the position is found by a binary search in
+  // LargeOffsets instead. This makes graphs with many high degree vertices slow, so use a CompactGraph for them.
+  static const uint32_t BlockSize = 16;
+  static const uint8_t LargeOffset = 0xff;
+
+  uint32_t NumberOfVertices;
+  uint32_t NumberOfEdges;
+
+  std::vector<uint8_t> Data;
+  std::vector<uint64_t> BlockOffsets;
+  std::vector<uint8_t> VertexOffsets;
+
+  // (vertex, position in Data) sorted by vertex
+  std::vector<std::pair<uint32_t, uint64_t> > LargeOffsets;
+
+  // Every varint ends with a byte whose high bit is clear, and an edge is two varints.
+  uint32_t Degree(const uint32_t v) const
+  {
+    const uint8_t* end = GetListEnd(v);
+    uint32_t numberOfVarints = 0;
+    for(const uint8_t* position = GetList(v); position < end; ++position)
+      {
+      numberOfVarints += (*position < 0x80);
+      }
+    return numberOfVarints / 2;
+  }
+
+  // Call visitor(neighbor, edgeId) for every edge of v.
+  template <typename TVisitor>
+  void ForEachNeighbor(const uint32_t v, TVisitor visitor) const
+  {
+    const uint8_t* position = GetList(v);
+    const uint8_t* end = GetListEnd(v);
+    if(position == end)
+      {
+      return;
+      }
+    uint32_t neighbor = v + UnZigzag(ReadVarint(position));
+    uint32_t edgeId = v + UnZigzag(ReadVarint(position));
+    visitor(neighbor, edgeId);
+    while(position < end)
+      {
+      neighbor = v + UnZigzag(ReadVarint(position));
+      edgeId += ReadVarint(position);
+      visitor(neighbor, edgeId);
+      }
+  }
+
+  static uint32_t ReadVarint(const uint8_t*& position)
+  {
+    uint32_t value = *position & 0x7f;
+    unsigned int shift = 7;
+    while(*position++ & 0x80)
+      {
+      value |= static_cast<uint32_t>(*position & 0x7f) << shift;
+      shift += 7;
+      }
+    return value;
+  }
+
+  // Differences are stored modulo 2^32, so unsigned wrap-around gives back the original value.
+  static uint32_t UnZigzag(const uint32_t value)
+  {
+    return (value >> 1) ^ (0u - (value & 1));
+  }
+
+private:
+  const uint8_t* GetList(const uint32_t v) const
+  {
+    const uint8_t offset = VertexOffsets[v];
+    if(offset != LargeOffset)
+      {
+      return Data.data() + BlockOffsets[v / BlockSize] + offset;
+      }
+    std::vector<std::pair<uint32_t, uint64_t> >::const_iterator large =
+      std::lower_bound(LargeOffsets.begin(), LargeOffsets.end(), std::make_pair(v, uint64_t(0)));
+    return Data.data() + large->second;
+  }
+
+  const uint8_t* GetListEnd(const uint32_t v) const
+  {
+    return (v + 1 < NumberOfVertices) ? GetList(v + 1) : Data.data() + Data.size();
+  }
+};
+
+// The number of bytes allocated by a CompressedGraph.
+size_t GetAllocatedBytes(const CompressedGraph& g);
+
+// Compress a CompactGraph. The vertex and edge ids stay the same.
+CompressedGraph CompressCompactGraph(const CompactGraph& g);
+
+#endif
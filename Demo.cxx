@@ -16,16 +16,21 @@
  *
  *=========================================================================*/
 
-// This program duplicates the functionality of the OpenGraph function
-// in GraphOpening.cxx . It does this so that the graph can be written
-// at each step for explanatory purposes.
+// This program opens a small example graph and writes the graph after every erosion and dilation to
+// eroded_i.dot and dilated_i.dot, for explanatory purposes, and the opened graph to opened.dot. Every file is
+// the original graph with the edges which do not exist at that step marked as invisible, written through a
+// view instead of a copy of the graph. With --levels it instead writes the graph once, with the erosion and
+// dilation in which every edge was removed and added back, to levels.dot and levels.bin. Both modes use the
+// tracking opening (see OpeningEngine.h), so the snapshots and the levels describe the same steps.
 
 // STL
 #include <sstream>
 
 // Custom
-#include "GraphOpeningNaive.h"
+#include "CompactGraph.h"
 #include "Helpers.h"
+#include "OpenedGraphView.h"
+#include "OpeningLevels.h"
 
 Graph CreateGraph();
 
@@ -34,7 +39,7 @@ int main(int argc, char *argv[])
   // Verify arguments
   if(argc < 2)
     {
-    std::cerr << "Required arguments: numberOfIterations" << std::endl;
+    std::cerr << "Required arguments: numberOfIterations [--levels] (both outputs use the tracking opening)" << std::endl;
     return -1;
     }
     
@@ -51,38 +56,43 @@ int main(int argc, char *argv[])
   std::cout << "Original graph: " << std::endl;
   OutputEdges(g);
   
-  // Initialize the eroded graph to the original graph
-  Graph erodedGraph = g;
-  
-  for(unsigned int i = 0; i < numberOfIterations; ++i)
+  // Every intermediate graph can be rebuilt from the levels with OpeningLevels::GetKeepMaskAfter*
+  OpeningLevels levels = ComputeOpeningLevelsFixed(CreateCompactGraph(g), numberOfIterations);
+
+  if(argc > 2 && std::string(argv[2]) == "--levels")
+    {
+    WriteOpeningLevelsDOT(g, levels, "levels.dot");
+    if(!WriteOpeningLevelsBinary(levels, "levels.bin"))
+      {
+      std::cerr << "Could not write levels.bin" << std::endl;
+      return -1;
+      }
+    return EXIT_SUCCESS;
+    }
+
+  // The edges of 'g' are indexed in the order of boost::edges(g), so the keep-masks of the levels can be used directly
+  for(unsigned int i = 0; i < levels.NumberOfErosions; ++i)
     {
     std::cout << std::endl << "Erosion " << i << std::endl;
-  
-    erodedGraph = ErodeNaive(erodedGraph);
-  
+
     std::stringstream ss;
     ss << "eroded_" << i << ".dot";
-    //WriteGraphWithVisibility(erodedGraph, ss.str());
-    Graph invisibleEdgeGraph = CreateInvisibleEdgeGraph(g, erodedGraph);
-    
-    WriteGraphWithVisibility(invisibleEdgeGraph, ss.str());
-
+    WriteGraphWithVisibility(OpenedGraphView(g, levels.GetKeepMaskAfterErosion(i + 1)), ss.str());
     }
-    
-  // Initialize the dilated graph to the last eroded graph
-  Graph dilatedGraph = erodedGraph;
-  
-  for(unsigned int i = 0; i < numberOfIterations; ++i)
+
+  for(unsigned int i = 0; i < levels.NumberOfErosions; ++i)
     {
     std::cout << std::endl << "Dilation " << i << std::endl;
-    dilatedGraph = DilateNaive(dilatedGraph, g);
-  
+
     std::stringstream ss;
     ss << "dilated_" << i << ".dot";
-    Graph invisibleEdgeGraph = CreateInvisibleEdgeGraph(g, dilatedGraph);
-    WriteGraphWithVisibility(invisibleEdgeGraph, ss.str());
+    WriteGraphWithVisibility(OpenedGraphView(g, levels.GetKeepMaskAfterDilation(i + 1)), ss.str());
     }
-  
+
+  OpenedGraphView opened = OpenGraphFixedView(g, numberOfIterations);
+  std::cout << std::endl << "Opened graph: " << opened.GetNumberOfKeptEdges() << " edges" << std::endl;
+  WriteGraphWithVisibility(opened, "opened.dot");
+
   return EXIT_SUCCESS;
 }
 
@@ -109,5 +119,6 @@ Graph CreateGraph()
   boost::add_edge(16,17,g);
   boost::add_edge(17,18,g);
  
+  IndexEdges(g);
   return g;
 }
@@ -0,0 +1,455 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "DistributedOpening.h"
+
+// STL
+#include <algorithm>
+#include <iostream>
+
+void ScatterEdges(const EdgeArrays& edges, const int root, MPI_Comm communicator, std::vector<uint32_t>& sources,
+                  std::vector<uint32_t>& targets, std::vector<uint64_t>& globalEdgeIds)
+{
+  int rank = 0;
+  int numberOfRanks = 0;
+  MPI_Comm_rank(communicator, &rank);
+  MPI_Comm_size(communicator, &numberOfRanks);
+
+  // Sort the edges by the ranks which store them: the owners of both end points
+  std::vector<int> counts(numberOfRanks, 0);
+  std::vector<int> offsets(numberOfRanks, 0);
+  std::vector<uint32_t> sendSources;
+  std::vector<uint32_t> sendTargets;
+  std::vector<uint64_t> sendIds;
+  if(rank == root)
+    {
+    for(size_t i = 0; i < edges.NumberOfEdges; ++i)
+      {
+      const int sourceOwner = GetOwner(edges.Sources[i], numberOfRanks);
+      const int targetOwner = GetOwner(edges.Targets[i], numberOfRanks);
+      counts[sourceOwner]++;
+      if(targetOwner != sourceOwner)
+        {
+        counts[targetOwner]++;
+        }
+      }
+    for(int r = 1; r < numberOfRanks; ++r)
+      {
+      offsets[r] = offsets[r - 1] + counts[r - 1];
+      }
+    const size_t numberOfSent = offsets.back() + counts.back();
+    sendSources.resize(numberOfSent);
+    sendTargets.resize(numberOfSent);
+    sendIds.resize(numberOfSent);
+    std::vector<int> positions(offsets);
+    for(size_t i = 0; i < edges.NumberOfEdges; ++i)
+      {
+      const int owners[2] = {GetOwner(edges.Sources[i], numberOfRanks), GetOwner(edges.Targets[i], numberOfRanks)};
+      for(unsigned int j = 0; j < (owners[0] == owners[1] ? 1u : 2u); ++j)
+        {
+        const int position = positions[owners[j]]++;
+        sendSources[position] = edges.Sources[i];
+        sendTargets[position] = edges.Targets[i];
+        sendIds[position] = i;
+        }
+      }
+    }
+
+  int numberOfReceived = 0;
+  MPI_Scatter(counts.data(), 1, MPI_INT, &numberOfReceived, 1, MPI_INT, root, communicator);
+  sources.resize(numberOfReceived);
+  targets.resize(numberOfReceived);
+  globalEdgeIds.resize(numberOfReceived);
+  MPI_Scatterv(sendSources.data(), counts.data(), offsets.data(), MPI_UINT32_T, sources.data(), numberOfReceived,
+               MPI_UINT32_T, root, communicator);
+  MPI_Scatterv(sendTargets.data(), counts.data(), offsets.data(), MPI_UINT32_T, targets.data(), numberOfReceived,
+               MPI_UINT32_T, root, communicator);
+  MPI_Scatterv(sendIds.data(), counts.data(), offsets.data(), MPI_UINT64_T, globalEdgeIds.data(), numberOfReceived,
+               MPI_UINT64_T, root, communicator);
+}
+
+DistributedGraph CreateDistributedGraph(const EdgeArrays& edges, const uint64_t* globalEdgeIds, MPI_Comm communicator)
+{
+  DistributedGraph g;
+  g.Communicator = communicator;
+  MPI_Comm_rank(communicator, &g.Rank);
+  MPI_Comm_size(communicator, &g.NumberOfRanks);
+
+  // Number the owned vertices first, then the ghosts, each in increasing global order
+  std::vector<uint32_t> owned;
+  std::vector<uint32_t> ghosts;
+  for(size_t i = 0; i < edges.NumberOfEdges; ++i)
+    {
+    const bool ownsSource = GetOwner(edges.Sources[i], g.NumberOfRanks) == g.Rank;
+    const bool ownsTarget = GetOwner(edges.Targets[i], g.NumberOfRanks) == g.Rank;
+    if(!ownsSource && !ownsTarget)
+      {
+      continue;
+      }
+    (ownsSource ? owned : ghosts).push_back(edges.Sources[i]);
+    (ownsTarget ? owned : ghosts).push_back(edges.Targets[i]);
+    }
+  std::sort(owned.begin(), owned.end());
+  owned.erase(std::unique(owned.begin(), owned.end()), owned.end());
+  std::sort(ghosts.begin(), ghosts.end());
+  ghosts.erase(std::unique(ghosts.begin(), ghosts.end()), ghosts.end());
+
+  g.NumberOfOwnedVertices = owned.size();
+  g.GlobalVertexIds.swap(owned);
+  g.GlobalVertexIds.insert(g.GlobalVertexIds.end(), ghosts.begin(), ghosts.end());
+  std::unordered_map<uint32_t, uint32_t> localVertexIds;
+  for(uint32_t v = 0; v < g.GlobalVertexIds.size(); ++v)
+    {
+    localVertexIds[g.GlobalVertexIds[v]] = v;
+    }
+
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  for(size_t i = 0; i < edges.NumberOfEdges; ++i)
+    {
+    const bool ownsSource = GetOwner(edges.Sources[i], g.NumberOfRanks) == g.Rank;
+    const bool ownsTarget = GetOwner(edges.Targets[i], g.NumberOfRanks) == g.Rank;
+    if(!ownsSource && !ownsTarget)
+      {
+      continue;
+      }
+    const uint32_t edge = sources.size();
+    const uint64_t globalEdgeId = globalEdgeIds ? globalEdgeIds[i] : i;
+    sources.push_back(localVertexIds[edges.Sources[i]]);
+    targets.push_back(localVertexIds[edges.Targets[i]]);
+    g.GlobalEdgeIds.push_back(globalEdgeId);
+    if(!ownsSource || !ownsTarget)
+      {
+      DistributedGraph::CrossEdge crossEdge = {edge, ownsSource ? sources.back() : targets.back()};
+      g.CrossEdges[globalEdgeId] = crossEdge;
+      }
+    }
+
+  EdgeArrays localEdges;
+  localEdges.Sources = sources.data();
+  localEdges.Targets = targets.data();
+  localEdges.NumberOfEdges = sources.size();
+  g.Adjacency = CreateCompactGraph(localEdges, g.GlobalVertexIds.size());
+  return g;
+}
+
+// Send outgoing[r] to rank r and replace 'incoming' with everything sent to this rank, in rank order.
+static void ExchangeEdges(const DistributedGraph& g, std::vector<std::vector<uint64_t> >& outgoing,
+                          std::vector<uint64_t>& incoming)
+{
+  std::vector<int> sendCounts(g.NumberOfRanks);
+  std::vector<int> sendOffsets(g.NumberOfRanks);
+  std::vector<uint64_t> sendBuffer;
+  for(int rank = 0; rank < g.NumberOfRanks; ++rank)
+    {
+    sendCounts[rank] = outgoing[rank].size();
+    sendOffsets[rank] = sendBuffer.size();
+    sendBuffer.insert(sendBuffer.end(), outgoing[rank].begin(), outgoing[rank].end());
+    outgoing[rank].clear();
+    }
+
+  std::vector<int> receiveCounts(g.NumberOfRanks);
+  MPI_Alltoall(sendCounts.data(), 1, MPI_INT, receiveCounts.data(), 1, MPI_INT, g.Communicator);
+  std::vector<int> receiveOffsets(g.NumberOfRanks);
+  int numberOfReceived = 0;
+  for(int rank = 0; rank < g.NumberOfRanks; ++rank)
+    {
+    receiveOffsets[rank] = numberOfReceived;
+    numberOfReceived += receiveCounts[rank];
+    }
+
+  incoming.resize(numberOfReceived);
+  MPI_Alltoallv(sendBuffer.data(), sendCounts.data(), sendOffsets.data(), MPI_UINT64_T,
+                incoming.data(), receiveCounts.data(), receiveOffsets.data(), MPI_UINT64_T, g.Communicator);
+}
+
+// The cross edge another rank sent the global id of. An id this rank does not store means the ranks were given
+// different graphs, which can not be recovered from.
+static const DistributedGraph::CrossEdge& FindCrossEdge(const DistributedGraph& g, const uint64_t globalEdgeId)
+{
+  std::unordered_map<uint64_t, DistributedGraph::CrossEdge>::const_iterator crossEdge = g.CrossEdges.find(globalEdgeId);
+  if(crossEdge == g.CrossEdges.end())
+    {
+    std::cerr << "Rank " << g.Rank << " received edge " << globalEdgeId << ", which is not one of its cross edges"
+              << std::endl;
+    MPI_Abort(g.Communicator, 1);
+    }
+  return crossEdge->second;
+}
+
+static uint64_t SumOverRanks(const DistributedGraph& g, uint64_t value)
+{
+  uint64_t sum = 0;
+  MPI_Allreduce(&value, &sum, 1, MPI_UINT64_T, MPI_SUM, g.Communicator);
+  return sum;
+}
+
+std::vector<bool> OpenDistributedGraphFixed(const DistributedGraph& g, unsigned int numberOfIterations,
+                                            unsigned int degreeThreshold, OpeningStatistics* statistics)
+{
+  const CompactGraph& adjacency = g.Adjacency;
+  const uint32_t numberOfOwned = g.NumberOfOwnedVertices;
+
+  // Every rank storing an edge marks it as removed/added back in the same round. An edge to a ghost is
+  // stored by two ranks, so edges are counted twice over and ghost edges once on each side.
+  const std::vector<uint32_t>& globalVertexIds = g.GlobalVertexIds;
+  auto isEndPoint = [&](const uint32_t degree)
+    {
+    return degree >= 1 && degree <= degreeThreshold;
+    };
+
+  Timer timer;
+  std::vector<uint32_t> degrees(numberOfOwned);
+  std::vector<uint32_t> edgeRounds(adjacency.NumberOfEdges, 0);
+  std::vector<uint32_t> current;
+  for(uint32_t v = 0; v < numberOfOwned; ++v)
+    {
+    degrees[v] = adjacency.Degree(v);
+    if(isEndPoint(degrees[v]))
+      {
+      current.push_back(v);
+      }
+    }
+  if(statistics)
+    {
+    statistics->FindEndPointsSeconds = timer.GetElapsedSeconds();
+    }
+
+  // 'stamps' holds the last round in which an owned vertex was added to 'touched' or 'potentialEndPoints'
+  std::vector<uint32_t> stamps(numberOfOwned, 0);
+  std::vector<uint32_t> touched;
+  std::vector<std::vector<uint64_t> > outgoing(g.NumberOfRanks);
+  std::vector<uint64_t> incoming;
+
+  for(unsigned int round = 1; round <= numberOfIterations; ++round)
+    {
+    timer.Restart();
+    const uint64_t frontierSize = SumOverRanks(g, current.size());
+    if(frontierSize == 0)
+      {
+      // Nothing will ever be removed again, and the dilation starts from nothing
+      touched.clear();
+      break;
+      }
+
+    touched.clear();
+    auto touch = [&](const uint32_t v)
+      {
+      if(stamps[v] != round)
+        {
+        stamps[v] = round;
+        touched.push_back(v);
+        }
+      };
+
+    // Remove the edges of the end points, which were decided before the round started
+    uint64_t numberOfEdgesRemoved = 0;
+    for(size_t i = 0; i < current.size(); ++i)
+      {
+      const uint32_t v = current[i];
+      adjacency.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t edge)
+        {
+        if(edgeRounds[edge] != 0)
+          {
+          return;
+          }
+        edgeRounds[edge] = round;
+        numberOfEdgesRemoved += g.IsOwned(neighbor) ? 2 : 1;
+        degrees[v]--;
+        touch(v);
+        if(g.IsOwned(neighbor))
+          {
+          degrees[neighbor]--;
+          touch(neighbor);
+          }
+        else
+          {
+          outgoing[GetOwner(globalVertexIds[neighbor], g.NumberOfRanks)].push_back(g.GlobalEdgeIds[edge]);
+          }
+        });
+      }
+
+    // Remove the edges other ranks removed from their side. An edge between two end points was removed by both.
+    ExchangeEdges(g, outgoing, incoming);
+    for(size_t i = 0; i < incoming.size(); ++i)
+      {
+      const DistributedGraph::CrossEdge& crossEdge = FindCrossEdge(g, incoming[i]);
+      if(edgeRounds[crossEdge.Edge] != 0)
+        {
+        continue;
+        }
+      edgeRounds[crossEdge.Edge] = round;
+      numberOfEdgesRemoved++;
+      degrees[crossEdge.OwnedVertex]--;
+      touch(crossEdge.OwnedVertex);
+      }
+
+    // Only a vertex which lost an edge can have become an end point
+    current.clear();
+    for(size_t i = 0; i < touched.size(); ++i)
+      {
+      if(isEndPoint(degrees[touched[i]]))
+        {
+        current.push_back(touched[i]);
+        }
+      }
+
+    if(statistics)
+      {
+      statistics->AddErosion(timer.GetElapsedSeconds(), frontierSize, SumOverRanks(g, numberOfEdgesRemoved) / 2);
+      }
+    }
+
+  // Dilate, starting from the vertices which lost an edge in the last erosion
+  std::vector<bool> keep(adjacency.NumberOfEdges);
+  for(uint32_t edge = 0; edge < adjacency.NumberOfEdges; ++edge)
+    {
+    keep[edge] = (edgeRounds[edge] == 0);
+    }
+  std::fill(stamps.begin(), stamps.end(), 0);
+  std::vector<uint32_t>& potentialEndPoints = touched;
+  std::vector<uint32_t> nextPotentialEndPoints;
+  std::vector<uint32_t> endPoints;
+  for(unsigned int dilation = 1; dilation <= numberOfIterations; ++dilation)
+    {
+    timer.Restart();
+    if(SumOverRanks(g, potentialEndPoints.size()) == 0)
+      {
+      break;
+      }
+
+    endPoints.clear();
+    for(size_t i = 0; i < potentialEndPoints.size(); ++i)
+      {
+      const uint32_t v = potentialEndPoints[i];
+      if(stamps[v] == dilation)
+        {
+        continue;
+        }
+      stamps[v] = dilation;
+      if(isEndPoint(degrees[v]))
+        {
+        endPoints.push_back(v);
+        }
+      }
+
+    // Add back all of the edges the end points had in the original graph
+    nextPotentialEndPoints.clear();
+    uint64_t numberOfEdgesRestored = 0;
+    for(size_t i = 0; i < endPoints.size(); ++i)
+      {
+      const uint32_t v = endPoints[i];
+      adjacency.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t edge)
+        {
+        if(keep[edge])
+          {
+          return;
+          }
+        keep[edge] = true;
+        numberOfEdgesRestored += g.IsOwned(neighbor) ? 2 : 1;
+        degrees[v]++;
+        if(g.IsOwned(neighbor))
+          {
+          degrees[neighbor]++;
+          nextPotentialEndPoints.push_back(neighbor);
+          }
+        else
+          {
+          outgoing[GetOwner(globalVertexIds[neighbor], g.NumberOfRanks)].push_back(g.GlobalEdgeIds[edge]);
+          }
+        });
+      }
+
+    ExchangeEdges(g, outgoing, incoming);
+    for(size_t i = 0; i < incoming.size(); ++i)
+      {
+      const DistributedGraph::CrossEdge& crossEdge = FindCrossEdge(g, incoming[i]);
+      if(keep[crossEdge.Edge])
+        {
+        continue;
+        }
+      keep[crossEdge.Edge] = true;
+      numberOfEdgesRestored++;
+      degrees[crossEdge.OwnedVertex]++;
+      nextPotentialEndPoints.push_back(crossEdge.OwnedVertex);
+      }
+    potentialEndPoints.swap(nextPotentialEndPoints);
+
+    if(statistics)
+      {
+      statistics->AddDilation(timer.GetElapsedSeconds(), SumOverRanks(g, endPoints.size()),
+                              SumOverRanks(g, numberOfEdgesRestored) / 2);
+      }
+    }
+
+  if(statistics)
+    {
+    size_t workspaceBytes = GetAllocatedBytes(degrees) + GetAllocatedBytes(edgeRounds) + GetAllocatedBytes(stamps) +
+                            GetAllocatedBytes(current) + GetAllocatedBytes(touched) + GetAllocatedBytes(endPoints) +
+                            GetAllocatedBytes(nextPotentialEndPoints) + GetAllocatedBytes(incoming) + GetAllocatedBytes(keep);
+    uint64_t peakWorkspaceBytes = 0;
+    uint64_t localWorkspaceBytes = workspaceBytes;
+    MPI_Allreduce(&localWorkspaceBytes, &peakWorkspaceBytes, 1, MPI_UINT64_T, MPI_MAX, g.Communicator);
+    statistics->UpdatePeakWorkspaceBytes(peakWorkspaceBytes);
+    }
+  return keep;
+}
+
+std::vector<bool> GatherKeepMask(const DistributedGraph& g, const std::vector<bool>& keep, int root)
+{
+  uint64_t localNumberOfEdges = 0;
+  std::vector<uint64_t> keptEdges;
+  for(size_t edge = 0; edge < keep.size(); ++edge)
+    {
+    localNumberOfEdges = std::max(localNumberOfEdges, g.GlobalEdgeIds[edge] + 1);
+    if(keep[edge])
+      {
+      keptEdges.push_back(g.GlobalEdgeIds[edge]);
+      }
+    }
+  uint64_t numberOfEdges = 0;
+  MPI_Reduce(&localNumberOfEdges, &numberOfEdges, 1, MPI_UINT64_T, MPI_MAX, root, g.Communicator);
+
+  int numberOfKeptEdges = keptEdges.size();
+  std::vector<int> counts(g.NumberOfRanks);
+  MPI_Gather(&numberOfKeptEdges, 1, MPI_INT, counts.data(), 1, MPI_INT, root, g.Communicator);
+  std::vector<int> offsets(g.NumberOfRanks, 0);
+  for(int rank = 1; rank < g.NumberOfRanks; ++rank)
+    {
+    offsets[rank] = offsets[rank - 1] + counts[rank - 1];
+    }
+  std::vector<uint64_t> allKeptEdges;
+  if(g.Rank == root)
+    {
+    allKeptEdges.resize(offsets.back() + counts.back());
+    }
+  MPI_Gatherv(keptEdges.data(), numberOfKeptEdges, MPI_UINT64_T, allKeptEdges.data(), counts.data(), offsets.data(),
+              MPI_UINT64_T, root, g.Communicator);
+
+  // An edge between two ranks is sent by both
+  std::vector<bool> globalKeep;
+  if(g.Rank == root)
+    {
+    globalKeep.assign(numberOfEdges, false);
+    for(size_t i = 0; i < allKeptEdges.size(); ++i)
+      {
+      globalKeep[allKeptEdges[i]] = true;
+      }
+    }
+  return globalKeep;
+}
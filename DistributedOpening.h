@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef DISTRIBUTEDOPENING_H
+#define DISTRIBUTEDOPENING_H
+
+// STL
+#include <unordered_map>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// MPI
+#include <mpi.h>
+
+// Custom
+#include "CompactGraph.h"
+#include "OpeningStatistics.h"
+
+/*
+The opening of a graph which is partitioned across the ranks of an MPI communicator. Every rank owns the
+vertices v with v % numberOfRanks == rank, and stores every edge with at least one owned end point. The
+other end point of an edge between two ranks is a ghost: its degree is only known to its owner.
+
+The rounds are bulk synchronous. In every erosion, each rank removes the edges of its own end points and
+sends the ids of the removed edges which lead to a ghost to the ghost's owner in a single all-to-all
+exchange. The owner then removes them too, so at the end of the round every rank knows the degree of every
+vertex it owns. The dilations add edges back in the same way. The results are the same as
+OpenGraphFixedTracking (and OpenCompactGraphFixed) on the whole graph.
+
+Only a fixed number of iterations is supported. The null removal difference rule counts a removal once for
+every time a vertex was pushed as a potential end point, so it would also need the push counts of the ghosts
+to be exchanged in every round; use OpenCompactGraphNullRemovalDifference on a single process for it.
+*/
+
+// The rank which owns a vertex
+inline int GetOwner(const uint32_t globalVertex, const int numberOfRanks)
+{
+  return globalVertex % numberOfRanks;
+}
+
+// The part of a graph stored on one rank.
+struct DistributedGraph
+{
+  MPI_Comm Communicator;
+  int Rank;
+  int NumberOfRanks;
+
+  // Local vertices [0, NumberOfOwnedVertices) are owned by this rank, the rest are ghosts.
+  uint32_t NumberOfOwnedVertices;
+  std::vector<uint32_t> GlobalVertexIds;
+
+  // The global id of every local edge.
+  std::vector<uint64_t> GlobalEdgeIds;
+
+  // An edge between an owned vertex and a ghost, found by its global id when the other rank changes it.
+  struct CrossEdge
+  {
+    uint32_t Edge;
+    uint32_t OwnedVertex;
+  };
+  std::unordered_map<uint64_t, CrossEdge> CrossEdges;
+
+  // The adjacency of all of the local vertices, in local ids. The edges of a ghost are only the ones to owned vertices.
+  CompactGraph Adjacency;
+
+  bool IsOwned(const uint32_t localVertex) const
+  {
+    return localVertex < NumberOfOwnedVertices;
+  }
+};
+
+// Read 'edges' on 'root' only, and send every rank of 'communicator' the edges with an end point it owns, with their
+// positions in 'edges' as global ids, so the other ranks never hold the whole graph. Pass the results to
+// CreateDistributedGraph. Every rank of the communicator must call this.
+void ScatterEdges(const EdgeArrays& edges, int root, MPI_Comm communicator, std::vector<uint32_t>& sources,
+                  std::vector<uint32_t>& targets, std::vector<uint64_t>& globalEdgeIds);
+
+// Create the part of a graph stored on this rank of 'communicator'. 'edges' must contain at least every edge with
+// an end point owned by this rank; the others are skipped, so every rank may be given the whole graph.
+// Edge i has the global id globalEdgeIds[i], or i if 'globalEdgeIds' is NULL.
+DistributedGraph CreateDistributedGraph(const EdgeArrays& edges, const uint64_t* globalEdgeIds, MPI_Comm communicator);
+
+// Open the graph with 'numberOfIterations' erosions and dilations. Every rank of the communicator must call this.
+// Returns a keep-mask over the local edges. If 'statistics' is not NULL it is filled in with the totals over all ranks.
+std::vector<bool> OpenDistributedGraphFixed(const DistributedGraph& g, unsigned int numberOfIterations,
+                                            unsigned int degreeThreshold = 1, OpeningStatistics* statistics = NULL);
+
+// Collect the keep-masks of all of the ranks into a keep-mask indexed by global edge id on 'root'.
+// The other ranks get an empty vector. Every rank of the communicator must call this.
+std::vector<bool> GatherKeepMask(const DistributedGraph& g, const std::vector<bool>& keep, int root = 0);
+
+#endif
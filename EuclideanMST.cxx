@@ -0,0 +1,442 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "EuclideanMST.h"
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+// Custom
+#include "Parallel.h"
+
+bool ReadPointCloud(const std::string& fileName, PointCloud& points)
+{
+  points.Coordinates.clear();
+  if(fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".bin") == 0)
+    {
+    std::ifstream fin(fileName.c_str(), std::ios::binary);
+    if(!fin)
+      {
+      return false;
+      }
+    fin.seekg(0, std::ios::end);
+    const size_t numberOfValues = static_cast<size_t>(fin.tellg()) / sizeof(float) / 3 * 3;
+    fin.seekg(0, std::ios::beg);
+    points.Coordinates.resize(numberOfValues);
+    fin.read(reinterpret_cast<char*>(points.Coordinates.data()), numberOfValues * sizeof(float));
+    return static_cast<bool>(fin);
+    }
+
+  std::ifstream fin(fileName.c_str());
+  if(!fin)
+    {
+    return false;
+    }
+  std::string line;
+  while(std::getline(fin, line))
+    {
+    std::stringstream ss(line);
+    float x, y, z;
+    if(ss >> x >> y >> z)
+      {
+      points.Coordinates.push_back(x);
+      points.Coordinates.push_back(y);
+      points.Coordinates.push_back(z);
+      }
+    }
+  return true;
+}
+
+namespace
+{
+
+const uint32_t LeafSize = 16;
+
+// A node of the kd-tree. It holds the points [Begin, End) of the tree order, and its children
+// (if it is not a leaf) are Left and Left + 1, split along SplitDimension.
+struct KdNode
+{
+  float Minimum[3];
+  float Maximum[3];
+  uint32_t Begin;
+  uint32_t End;
+  uint32_t Left;
+  uint32_t SplitDimension;
+};
+
+// A kd-tree with the points stored in tree order, so the points of a node are contiguous in memory.
+class KdTree
+{
+public:
+  KdTree(const PointCloud& cloud) : NumberOfPoints(cloud.GetNumberOfPoints())
+  {
+    Order.resize(NumberOfPoints);
+    for(uint32_t i = 0; i < NumberOfPoints; ++i)
+      {
+      Order[i] = i;
+      }
+    Nodes.push_back(KdNode());
+    Split(cloud, 0, 0, NumberOfPoints);
+
+    Points.resize(3 * NumberOfPoints);
+    ParallelFor(0, NumberOfPoints, [&](const size_t begin, const size_t end, const unsigned int)
+      {
+      for(size_t i = begin; i < end; ++i)
+        {
+        for(unsigned int d = 0; d < 3; ++d)
+          {
+          Points[3 * i + d] = cloud.Coordinates[3 * Order[i] + d];
+          }
+        }
+      });
+  }
+
+  uint32_t NumberOfPoints;
+
+  // The original index of the point at every position of the tree order
+  std::vector<uint32_t> Order;
+  std::vector<float> Points;
+
+  // In preorder, so every child comes after its parent
+  std::vector<KdNode> Nodes;
+
+private:
+  // Fill in node 'nodeId' with the points [begin, end) of Order and split it at the median of its widest dimension
+  void Split(const PointCloud& cloud, const uint32_t nodeId, const uint32_t begin, const uint32_t end)
+  {
+    KdNode node;
+    node.Begin = begin;
+    node.End = end;
+    node.Left = 0;
+    node.SplitDimension = 0;
+    for(unsigned int d = 0; d < 3; ++d)
+      {
+      node.Minimum[d] = std::numeric_limits<float>::max();
+      node.Maximum[d] = -std::numeric_limits<float>::max();
+      }
+    for(uint32_t i = begin; i < end; ++i)
+      {
+      for(unsigned int d = 0; d < 3; ++d)
+        {
+        node.Minimum[d] = std::min(node.Minimum[d], cloud.Coordinates[3 * Order[i] + d]);
+        node.Maximum[d] = std::max(node.Maximum[d], cloud.Coordinates[3 * Order[i] + d]);
+        }
+      }
+
+    if(end - begin > LeafSize)
+      {
+      unsigned int widest = 0;
+      for(unsigned int d = 1; d < 3; ++d)
+        {
+        if(node.Maximum[d] - node.Minimum[d] > node.Maximum[widest] - node.Minimum[widest])
+          {
+          widest = d;
+          }
+        }
+      const uint32_t middle = begin + (end - begin) / 2;
+      std::nth_element(Order.begin() + begin, Order.begin() + middle, Order.begin() + end,
+                       [&](const uint32_t a, const uint32_t b)
+                       {
+                         return cloud.Coordinates[3 * a + widest] < cloud.Coordinates[3 * b + widest];
+                       });
+      node.Left = Nodes.size();
+      node.SplitDimension = widest;
+      Nodes.push_back(KdNode());
+      Nodes.push_back(KdNode());
+      Nodes[nodeId] = node;
+      Split(cloud, node.Left, begin, middle);
+      Split(cloud, node.Left + 1, middle, end);
+      return;
+      }
+    Nodes[nodeId] = node;
+  }
+};
+
+// A candidate edge. Edges are compared by length, then by their end points, so no two edges are equal.
+struct Candidate
+{
+  float SquaredDistance;
+  uint32_t Low;
+  uint32_t High;
+
+  bool operator<(const Candidate& other) const
+  {
+    if(SquaredDistance != other.SquaredDistance)
+      {
+      return SquaredDistance < other.SquaredDistance;
+      }
+    if(Low != other.Low)
+      {
+      return Low < other.Low;
+      }
+    return High < other.High;
+  }
+};
+
+const uint32_t NoPoint = std::numeric_limits<uint32_t>::max();
+
+// Marks a node whose points are not all in the same component
+const uint32_t Mixed = std::numeric_limits<uint32_t>::max();
+
+uint32_t FloatBits(const float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float BitsFloat(const uint32_t bits)
+{
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void AtomicMinimum(std::atomic<uint32_t>& minimum, const uint32_t value)
+{
+  uint32_t current = minimum.load(std::memory_order_relaxed);
+  while(value < current && !minimum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+uint32_t FindRoot(std::vector<uint32_t>& parents, uint32_t v)
+{
+  while(parents[v] != v)
+    {
+    parents[v] = parents[parents[v]];
+    v = parents[v];
+    }
+  return v;
+}
+
+} // namespace
+
+void ComputeEuclideanMST(const PointCloud& cloud, std::vector<uint32_t>& sources, std::vector<uint32_t>& targets)
+{
+  sources.clear();
+  targets.clear();
+  if(cloud.GetNumberOfPoints() < 2)
+    {
+    return;
+    }
+
+  // All of the work is done in tree order and mapped back at the end
+  const KdTree tree(cloud);
+  const uint32_t numberOfPoints = tree.NumberOfPoints;
+  const std::vector<float>& points = tree.Points;
+  const std::vector<KdNode>& nodes = tree.Nodes;
+
+  std::vector<uint32_t> parents(numberOfPoints);
+  std::vector<uint32_t> components(numberOfPoints);
+  for(uint32_t i = 0; i < numberOfPoints; ++i)
+    {
+    parents[i] = i;
+    components[i] = i;
+    }
+  std::vector<uint32_t> nodeComponents(nodes.size());
+  const Candidate none = {std::numeric_limits<float>::max(), NoPoint, NoPoint};
+  std::vector<Candidate> nearest(numberOfPoints, none);
+  std::vector<std::atomic<uint32_t> > componentBounds(numberOfPoints);
+  std::vector<float> lowerBounds(numberOfPoints, 0);
+  std::vector<Candidate> shortest(numberOfPoints);
+
+  uint32_t numberOfComponents = numberOfPoints;
+  while(numberOfComponents > 1)
+    {
+    // A node whose points are all in one component is skipped by the searches from that component
+    for(size_t n = nodes.size(); n > 0; --n)
+      {
+      const KdNode& node = nodes[n - 1];
+      if(node.Left == 0)
+        {
+        uint32_t component = components[node.Begin];
+        for(uint32_t i = node.Begin + 1; i < node.End && component != Mixed; ++i)
+          {
+          if(components[i] != component)
+            {
+            component = Mixed;
+            }
+          }
+        nodeComponents[n - 1] = component;
+        }
+      else
+        {
+        const uint32_t left = nodeComponents[node.Left];
+        nodeComponents[n - 1] = (left == nodeComponents[node.Left + 1]) ? left : Mixed;
+        }
+      }
+
+    // The squared length of the shortest edge found so far out of every component, as the bits of a
+    // positive float (which are ordered like the floats). A search never needs to look farther.
+    for(uint32_t p = 0; p < numberOfPoints; ++p)
+      {
+      if(components[p] == p)
+        {
+        componentBounds[p] = FloatBits(std::numeric_limits<float>::max());
+        }
+      }
+
+    // The nearest point in another component found in an earlier round is still the nearest if it has
+    // not been merged into the component of the point, because the other components only shrink
+    ParallelFor(0, numberOfPoints, [&](const size_t begin, const size_t end, const unsigned int)
+      {
+      for(size_t p = begin; p < end; ++p)
+        {
+        const Candidate& candidate = nearest[p];
+        if(candidate.Low != NoPoint && components[candidate.Low] != components[candidate.High])
+          {
+          AtomicMinimum(componentBounds[components[p]], FloatBits(candidate.SquaredDistance));
+          }
+        else
+          {
+          nearest[p] = none;
+          }
+        }
+      });
+
+    // Find the nearest point in another component of every other point
+    ParallelFor(0, numberOfPoints, [&](const size_t begin, const size_t end, const unsigned int)
+      {
+      std::vector<uint32_t> stack;
+      for(size_t p = begin; p < end; ++p)
+        {
+        if(nearest[p].Low != NoPoint)
+          {
+          continue;
+          }
+        const float* point = &points[3 * p];
+        const uint32_t component = components[p];
+        float bestDistance = BitsFloat(componentBounds[component].load(std::memory_order_relaxed));
+
+        // The nearest point in another component can not be nearer than it was in the last round
+        if(lowerBounds[p] > bestDistance)
+          {
+          continue;
+          }
+        uint32_t best = NoPoint;
+        stack.assign(1, 0);
+        while(!stack.empty())
+          {
+          const uint32_t nodeId = stack.back();
+          const KdNode& node = nodes[nodeId];
+          stack.pop_back();
+          if(nodeComponents[nodeId] == component)
+            {
+            continue;
+            }
+          float boxDistance = 0;
+          for(unsigned int d = 0; d < 3; ++d)
+            {
+            const float outside = std::max(std::max(node.Minimum[d] - point[d], point[d] - node.Maximum[d]), 0.0f);
+            boxDistance += outside * outside;
+            }
+          if(boxDistance > bestDistance)
+            {
+            continue;
+            }
+          if(node.Left == 0)
+            {
+            for(uint32_t q = node.Begin; q < node.End; ++q)
+              {
+              if(components[q] == component)
+                {
+                continue;
+                }
+              const float dx = points[3 * q] - point[0];
+              const float dy = points[3 * q + 1] - point[1];
+              const float dz = points[3 * q + 2] - point[2];
+              const float distance = dx * dx + dy * dy + dz * dz;
+              // Of two equally near points, the one with the smaller index gives the smaller edge
+              if(distance < bestDistance || (distance == bestDistance && q < best))
+                {
+                bestDistance = distance;
+                best = q;
+                }
+              }
+            continue;
+            }
+
+          // Visit the nearer child first
+          if(point[node.SplitDimension] < nodes[node.Left + 1].Minimum[node.SplitDimension])
+            {
+            stack.push_back(node.Left + 1);
+            stack.push_back(node.Left);
+            }
+          else
+            {
+            stack.push_back(node.Left);
+            stack.push_back(node.Left + 1);
+            }
+          }
+        // If nothing is nearer than the bound, another point of the component has a shorter edge
+        if(best != NoPoint)
+          {
+          Candidate candidate = {bestDistance, static_cast<uint32_t>(std::min<size_t>(p, best)),
+                                 static_cast<uint32_t>(std::max<size_t>(p, best))};
+          nearest[p] = candidate;
+          lowerBounds[p] = bestDistance;
+          AtomicMinimum(componentBounds[component], FloatBits(bestDistance));
+          }
+        }
+      });
+
+    // Merge every component along its shortest outgoing edge
+    for(uint32_t p = 0; p < numberOfPoints; ++p)
+      {
+      if(components[p] == p)
+        {
+        shortest[p] = none;
+        }
+      }
+    for(uint32_t p = 0; p < numberOfPoints; ++p)
+      {
+      if(nearest[p] < shortest[components[p]])
+        {
+        shortest[components[p]] = nearest[p];
+        }
+      }
+    for(uint32_t p = 0; p < numberOfPoints; ++p)
+      {
+      if(components[p] != p || shortest[p].Low == NoPoint)
+        {
+        continue;
+        }
+      const uint32_t a = FindRoot(parents, shortest[p].Low);
+      const uint32_t b = FindRoot(parents, shortest[p].High);
+      if(a == b)
+        {
+        // Both components chose the same edge
+        continue;
+        }
+      parents[std::max(a, b)] = std::min(a, b);
+      sources.push_back(tree.Order[shortest[p].Low]);
+      targets.push_back(tree.Order[shortest[p].High]);
+      numberOfComponents--;
+      }
+    for(uint32_t p = 0; p < numberOfPoints; ++p)
+      {
+      components[p] = FindRoot(parents, p);
+      }
+    }
+}
@@ -0,0 +1,56 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef EUCLIDEANMST_H
+#define EUCLIDEANMST_H
+
+// STL
+#include <string>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "CompactGraph.h"
+
+// Points in 3D, stored as x0 y0 z0 x1 y1 z1 ...
+struct PointCloud
+{
+  std::vector<float> Coordinates;
+
+  size_t GetNumberOfPoints() const
+  {
+    return Coordinates.size() / 3;
+  }
+};
+
+// Read a point cloud. A file ending in .bin holds consecutive x y z float32 values in the byte order of the
+// machine. Any other file is text with the x y z coordinates of one point per line, and further columns are ignored.
+// Returns false if the file could not be read.
+bool ReadPointCloud(const std::string& fileName, PointCloud& points);
+
+// The minimum spanning tree of the complete graph on the points, weighted by Euclidean distance, as edge arrays
+// whose vertex ids are the indices of the points. It is computed by Boruvka's algorithm: in every round each
+// point finds its nearest neighbor in another component with a kd-tree, skipping subtrees which lie entirely
+// in its own component, and each component is merged along its shortest outgoing edge. The nearest neighbor
+// searches run on all of the cores. Equally long edges are ordered by their end points, so the tree is the
+// same for any number of threads.
+void ComputeEuclideanMST(const PointCloud& points, std::vector<uint32_t>& sources, std::vector<uint32_t>& targets);
+
+#endif
@@ -0,0 +1,390 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// This program opens many graphs in one process. A reader thread reads the input files, a pool of workers
+// parses and opens them, and a writer thread writes the results; the stages are connected by bounded
+// queues so reading, opening and writing overlap. The input is one of
+//   a directory      every .dot file in it is opened and written to outputDirectory under the same name
+//   @list.txt        a file with one input file name per line
+//   graphs.dot or -  a file (or the standard input) holding one or more concatenated graphs, which are
+//                    written to outputDirectory as graph_0.dot, graph_1.dot, ...
+// Every graph is opened until the number of removals has been constant for goalNumberOfSuccessiveNullDifferences
+// erosions, as by GraphOpeningNullRemovalDifferenceExample. With --cache=directory the results are kept in an
+// OpeningCache of at most --cache-size megabytes (1024 by default), so unchanged graphs are not opened again.
+// The self loops and duplicate edges of every graph are removed before it is opened, unless --keep-duplicates is given.
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// C
+#include <dirent.h>
+
+// Boost
+#include <boost/graph/graphviz.hpp>
+
+// Custom
+#include "BoundedQueue.h"
+#include "CompactGraph.h"
+#include "GraphOpeningPeeling.h"
+#include "Helpers.h"
+#include "OpenedGraphView.h"
+#include "OpeningCache.h"
+#include "OpeningStatistics.h"
+
+// A graph waiting to be opened
+struct Job
+{
+  std::string Name;
+  std::string Text;
+};
+
+// An opened graph waiting to be written
+struct Result
+{
+  std::string Name;
+  std::string Text;
+};
+
+static bool ReadFile(const std::string& fileName, std::string& text)
+{
+  std::ifstream fin(fileName.c_str(), std::ios::binary);
+  if(!fin)
+    {
+    return false;
+    }
+  std::stringstream ss;
+  ss << fin.rdbuf();
+  text = ss.str();
+  return true;
+}
+
+// The part of a path after the last '/'
+static std::string GetFileName(const std::string& path)
+{
+  size_t slash = path.find_last_of('/');
+  return (slash == std::string::npos) ? path : path.substr(slash + 1);
+}
+
+// The sorted names of the .dot files in a directory. Returns false if it is not a directory.
+static bool ListDirectory(const std::string& directory, std::vector<std::string>& fileNames)
+{
+  DIR* dir = opendir(directory.c_str());
+  if(!dir)
+    {
+    return false;
+    }
+  while(dirent* entry = readdir(dir))
+    {
+    std::string name = entry->d_name;
+    if(name.size() > 4 && name.compare(name.size() - 4, 4, ".dot") == 0)
+      {
+      fileNames.push_back(directory + "/" + name);
+      }
+    }
+  closedir(dir);
+  std::sort(fileNames.begin(), fileNames.end());
+  return true;
+}
+
+// Split a stream of concatenated graphs after every closing brace at the outermost level,
+// pushing one job per graph.
+static void SplitGraphs(std::istream& stream, BoundedQueue<Job>& jobs)
+{
+  Job job;
+  unsigned int numberOfGraphs = 0;
+  int depth = 0;
+  bool inString = false;
+  char previous = 0;
+  char c;
+  while(stream.get(c))
+    {
+    job.Text += c;
+    if(inString)
+      {
+      inString = !(c == '"' && previous != '\\');
+      }
+    else if(c == '"')
+      {
+      inString = true;
+      }
+    else if(c == '{')
+      {
+      depth++;
+      }
+    else if(c == '}' && --depth == 0)
+      {
+      std::stringstream name;
+      name << "graph_" << numberOfGraphs << ".dot";
+      job.Name = name.str();
+      jobs.Push(std::move(job));
+      job = Job();
+      numberOfGraphs++;
+      }
+    previous = c;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+  // Separate the options from the required arguments
+  std::vector<std::string> arguments;
+  unsigned int numberOfWorkers = std::max(1u, std::thread::hardware_concurrency());
+  unsigned int queueLength = 64;
+  std::string cacheDirectory;
+  uint64_t cacheMegabytes = 1024;
+  bool clean = true;
+  for(int i = 1; i < argc; ++i)
+    {
+    std::string argument = argv[i];
+    if(argument.compare(0, 10, "--workers=") == 0)
+      {
+      std::stringstream ss(argument.substr(10));
+      ss >> numberOfWorkers;
+      }
+    else if(argument.compare(0, 8, "--queue=") == 0)
+      {
+      std::stringstream ss(argument.substr(8));
+      ss >> queueLength;
+      }
+    else if(argument.compare(0, 8, "--cache=") == 0)
+      {
+      cacheDirectory = argument.substr(8);
+      }
+    else if(argument.compare(0, 13, "--cache-size=") == 0)
+      {
+      std::stringstream ss(argument.substr(13));
+      ss >> cacheMegabytes;
+      }
+    else if(argument == "--keep-duplicates")
+      {
+      clean = false;
+      }
+    else
+      {
+      arguments.push_back(argument);
+      }
+    }
+
+  // Verify arguments
+  if(arguments.size() < 3 || numberOfWorkers == 0 || queueLength == 0)
+    {
+    std::cerr << "Required arguments: goalNumberOfSuccessiveNullDifferences outputDirectory (directory | @list.txt | graphs.dot | -)"
+              << " [--workers=N] [--queue=N] [--cache=directory] [--cache-size=megabytes] [--keep-duplicates]" << std::endl;
+    return -1;
+    }
+
+  // Parse arguments
+  unsigned int goalNumberOfSuccessiveNullDifferences = 0;
+  std::stringstream ss(arguments[0]);
+  ss >> goalNumberOfSuccessiveNullDifferences;
+
+  std::string outputDirectory = arguments[1];
+  std::string input = arguments[2];
+
+  // Output arguments
+  std::cout << "Goal number of successive null differences: " << goalNumberOfSuccessiveNullDifferences << std::endl;
+  std::cout << "Output directory: " << outputDirectory << std::endl;
+  std::cout << "Input: " << input << std::endl;
+  std::cout << "Workers: " << numberOfWorkers << std::endl;
+
+  std::unique_ptr<OpeningCache> cache;
+  if(!cacheDirectory.empty())
+    {
+    std::cout << "Cache: " << cacheDirectory << std::endl;
+    cache.reset(new OpeningCache(cacheDirectory, cacheMegabytes << 20));
+    }
+
+  // Decide what to read before starting any threads
+  std::vector<std::string> fileNames;
+  bool isStream = false;
+  if(input.compare(0, 1, "@") == 0)
+    {
+    std::ifstream fin(input.substr(1).c_str());
+    if(!fin)
+      {
+      std::cerr << "Could not read " << input.substr(1) << std::endl;
+      return -1;
+      }
+    std::string line;
+    while(std::getline(fin, line))
+      {
+      if(!line.empty())
+        {
+        fileNames.push_back(line);
+        }
+      }
+    }
+  else if(input == "-" || !ListDirectory(input, fileNames))
+    {
+    isStream = true;
+    }
+
+  BoundedQueue<Job> jobs(queueLength);
+  BoundedQueue<Result> results(queueLength);
+  std::atomic<size_t> numberOfEdges(0);
+  std::atomic<unsigned int> numberOfFailures(0);
+  std::atomic<unsigned int> numberOfCacheHits(0);
+  std::atomic<size_t> numberOfRemovedEdges(0);
+  std::atomic<unsigned int> numberOfRunningWorkers(numberOfWorkers);
+  Timer timer;
+
+  std::thread reader([&]()
+    {
+    if(isStream && input == "-")
+      {
+      SplitGraphs(std::cin, jobs);
+      }
+    else if(isStream)
+      {
+      std::ifstream fin(input.c_str(), std::ios::binary);
+      if(!fin)
+        {
+        std::cerr << "Could not read " << input << std::endl;
+        numberOfFailures++;
+        }
+      SplitGraphs(fin, jobs);
+      }
+    else
+      {
+      for(size_t i = 0; i < fileNames.size(); ++i)
+        {
+        Job job;
+        job.Name = GetFileName(fileNames[i]);
+        if(!ReadFile(fileNames[i], job.Text))
+          {
+          std::cerr << "Could not read " << fileNames[i] << std::endl;
+          numberOfFailures++;
+          continue;
+          }
+        jobs.Push(std::move(job));
+        }
+      }
+    jobs.Close();
+    });
+
+  std::vector<std::thread> workers;
+  for(unsigned int i = 0; i < numberOfWorkers; ++i)
+    {
+    workers.push_back(std::thread([&]()
+      {
+      Job job;
+      while(jobs.Pop(job))
+        {
+        try
+          {
+          std::stringstream text(job.Text);
+          size_t numberOfRemovedGraphEdges = 0;
+          Graph graph = ReadGraph(text, &numberOfRemovedGraphEdges, clean);
+          numberOfEdges += boost::num_edges(graph) + numberOfRemovedGraphEdges;
+          numberOfRemovedEdges += numberOfRemovedGraphEdges;
+
+          std::vector<bool> keep;
+          CacheKey key;
+          if(cache)
+            {
+            key = ComputeCacheKey(graph, CachedNullRemovalDifference, goalNumberOfSuccessiveNullDifferences);
+            }
+          if(cache && cache->Find(key, keep) && keep.size() == boost::num_edges(graph))
+            {
+            numberOfCacheHits++;
+            }
+          else
+            {
+            keep = OpenCompactGraphNullRemovalDifference(CreateCompactGraph(graph), goalNumberOfSuccessiveNullDifferences);
+            if(cache)
+              {
+              cache->Store(key, keep);
+              }
+            }
+          OpenedGraphView openedGraph(graph, keep);
+
+          Result result;
+          result.Name = job.Name;
+          std::stringstream output;
+          boost::write_graphviz(output, openedGraph.GetFilteredGraph());
+          result.Text = output.str();
+          results.Push(std::move(result));
+          }
+        catch(const std::exception& exception)
+          {
+          std::cerr << "Could not open " << job.Name << ": " << exception.what() << std::endl;
+          numberOfFailures++;
+          }
+        }
+      // The last worker to finish tells the writer
+      if(--numberOfRunningWorkers == 0)
+        {
+        results.Close();
+        }
+      }));
+    }
+
+  unsigned int numberOfFiles = 0;
+  std::thread writer([&]()
+    {
+    Result result;
+    while(results.Pop(result))
+      {
+      std::string fileName = outputDirectory + "/" + result.Name;
+      std::ofstream fout(fileName.c_str(), std::ios::binary);
+      fout << result.Text;
+      if(!fout)
+        {
+        std::cerr << "Could not write " << fileName << std::endl;
+        numberOfFailures++;
+        continue;
+        }
+      numberOfFiles++;
+      }
+    });
+
+  reader.join();
+  for(unsigned int i = 0; i < workers.size(); ++i)
+    {
+    workers[i].join();
+    }
+  writer.join();
+
+  double seconds = timer.GetElapsedSeconds();
+  std::cout << "Opened " << numberOfFiles << " graphs with " << numberOfEdges << " edges in " << seconds << " s" << std::endl;
+  std::cout << std::fixed << std::setprecision(1) << numberOfFiles / seconds << " files/s, "
+            << numberOfEdges / seconds << " edges/s" << std::endl;
+  if(clean)
+    {
+    std::cout << numberOfRemovedEdges << " self loops and duplicate edges were removed" << std::endl;
+    }
+  if(cache)
+    {
+    std::cout << numberOfCacheHits << " graphs were found in the cache" << std::endl;
+    }
+  if(numberOfFailures > 0)
+    {
+    std::cerr << numberOfFailures << " graphs failed" << std::endl;
+    return -1;
+    }
+  return EXIT_SUCCESS;
+}
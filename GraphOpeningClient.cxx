@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// This program sends one graph to a running GraphOpeningServer and writes what it sends back. An input
+// file ending in .dot is sent as a .dot graph, anything else is sent as an edge list (see OpeningProtocol.h).
+// The output is the opened graph in the format of the input, or with --mask the keep-mask as one 0 or 1
+// per line, in the order of the edges of the input.
+
+// STL
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// C
+#include <unistd.h>
+
+// Custom
+#include "OpeningProtocol.h"
+#include "OpeningStatistics.h"
+
+int main(int argc, char *argv[])
+{
+  // Separate the options from the required arguments
+  std::vector<std::string> arguments;
+  bool writeMask = false;
+  unsigned int degreeThreshold = 1;
+  for(int i = 1; i < argc; ++i)
+    {
+    std::string argument = argv[i];
+    if(argument == "--mask")
+      {
+      writeMask = true;
+      }
+    else if(argument.compare(0, 9, "--degree=") == 0)
+      {
+      std::stringstream ss(argument.substr(9));
+      ss >> degreeThreshold;
+      }
+    else
+      {
+      arguments.push_back(argument);
+      }
+    }
+
+  // Verify arguments
+  if(arguments.size() < 5 || (arguments[1] != "fixed" && arguments[1] != "nrd"))
+    {
+    std::cerr << "Required arguments: socketPath (fixed | nrd) numberOfIterations|goalNumberOfSuccessiveNullDifferences"
+              << " input output [--mask] [--degree=N]" << std::endl;
+    return -1;
+    }
+
+  // Parse arguments
+  std::string socketPath = arguments[0];
+  OpeningRequest request;
+  request.Algorithm = (arguments[1] == "fixed") ? FixedIterationsAlgorithm : NullRemovalDifferenceAlgorithm;
+  std::stringstream ss(arguments[2]);
+  ss >> request.Parameter;
+  std::string inputFileName = arguments[3];
+  std::string outputFileName = arguments[4];
+  request.DegreeThreshold = degreeThreshold;
+  request.Reply = writeMask ? KeepMaskReply : GraphReply;
+  const bool isDOT = inputFileName.size() > 4 && inputFileName.compare(inputFileName.size() - 4, 4, ".dot") == 0;
+  request.Format = isDOT ? DOTGraphFormat : EdgeListGraphFormat;
+
+  std::ifstream fin(inputFileName.c_str(), std::ios::binary);
+  if(!fin)
+    {
+    std::cerr << "Could not read " << inputFileName << std::endl;
+    return -1;
+    }
+  std::stringstream input;
+  input << fin.rdbuf();
+  request.Payload = input.str();
+
+  int connection = ConnectToUnixSocket(socketPath);
+  if(connection < 0)
+    {
+    std::cerr << "Could not connect to " << socketPath << std::endl;
+    return -1;
+    }
+
+  Timer timer;
+  OpeningReply reply;
+  bool answered = WriteRequest(connection, request) && ReadReply(connection, reply);
+  close(connection);
+  if(!answered)
+    {
+    std::cerr << "The server closed the connection" << std::endl;
+    return -1;
+    }
+  if(!reply.Succeeded)
+    {
+    std::cerr << "The server could not open the graph: " << reply.Payload << std::endl;
+    return -1;
+    }
+  std::cout << "Opened in " << timer.GetElapsedSeconds() * 1000 << " ms" << std::endl;
+
+  std::ofstream fout(outputFileName.c_str(), std::ios::binary);
+  if(writeMask)
+    {
+    std::vector<bool> keep;
+    if(!DecodeKeepMask(reply.Payload, keep))
+      {
+      std::cerr << "Malformed keep-mask" << std::endl;
+      return -1;
+      }
+    for(size_t edgeId = 0; edgeId < keep.size(); ++edgeId)
+      {
+      fout << keep[edgeId] << "\n";
+      }
+    }
+  else
+    {
+    fout << reply.Payload;
+    }
+  if(!fout)
+    {
+    std::cerr << "Could not write " << outputFileName << std::endl;
+    return -1;
+    }
+  return EXIT_SUCCESS;
+}
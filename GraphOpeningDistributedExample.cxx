@@ -0,0 +1,116 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// This program opens a graph with several MPI ranks, for example
+//   mpirun -np 4 GraphOpeningDistributedExample input.dot numberOfIterations output.dot
+// Rank 0 reads the file and sends every rank its own part of the graph, so only rank 0 holds the whole graph.
+// Rank 0 then collects the result and writes it to a file.
+
+// STL
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Custom
+#include "DistributedOpening.h"
+#include "Helpers.h"
+#include "OpenedGraphView.h"
+
+int main(int argc, char *argv[])
+{
+  MPI_Init(&argc, &argv);
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  // Verify arguments
+  if(argc < 4)
+    {
+    if(rank == 0)
+      {
+      std::cerr << "Required arguments: input.dot numberOfIterations output.dot" << std::endl;
+      }
+    MPI_Finalize();
+    return -1;
+    }
+
+  // Parse arguments
+  std::string inputFileName = argv[1];
+
+  unsigned int numberOfIterations = 0;
+  std::stringstream ss(argv[2]);
+  ss >> numberOfIterations;
+
+  std::string outputFileName = argv[3];
+
+  if(rank == 0)
+    {
+    int numberOfRanks = 0;
+    MPI_Comm_size(MPI_COMM_WORLD, &numberOfRanks);
+    std::cout << "Input: " << inputFileName << std::endl;
+    std::cout << "Number of iterations: " << numberOfIterations << std::endl;
+    std::cout << "Output: " << outputFileName << std::endl;
+    std::cout << "Number of ranks: " << numberOfRanks << std::endl;
+    }
+
+  // Read the graph on rank 0 only
+  Graph graph;
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  if(rank == 0)
+    {
+    size_t numberOfRemovedEdges = 0;
+    graph = ReadGraph(inputFileName, &numberOfRemovedEdges);
+    std::cout << "Removed " << numberOfRemovedEdges << " self loops and duplicate edges" << std::endl;
+    std::pair<Graph::edge_iterator, Graph::edge_iterator> edgeRange = boost::edges(graph);
+    for(Graph::edge_iterator iterator = edgeRange.first; iterator != edgeRange.second; ++iterator)
+      {
+      sources.push_back(boost::source(*iterator, graph));
+      targets.push_back(boost::target(*iterator, graph));
+      }
+    }
+  EdgeArrays edges;
+  edges.Sources = sources.data();
+  edges.Targets = targets.data();
+  edges.NumberOfEdges = sources.size();
+
+  std::vector<uint32_t> localSources;
+  std::vector<uint32_t> localTargets;
+  std::vector<uint64_t> globalEdgeIds;
+  ScatterEdges(edges, 0, MPI_COMM_WORLD, localSources, localTargets, globalEdgeIds);
+  std::vector<uint32_t>().swap(sources);
+  std::vector<uint32_t>().swap(targets);
+  EdgeArrays localEdges;
+  localEdges.Sources = localSources.data();
+  localEdges.Targets = localTargets.data();
+  localEdges.NumberOfEdges = localSources.size();
+
+  DistributedGraph distributedGraph = CreateDistributedGraph(localEdges, globalEdgeIds.data(), MPI_COMM_WORLD);
+  std::vector<bool> keep = OpenDistributedGraphFixed(distributedGraph, numberOfIterations);
+  std::vector<bool> globalKeep = GatherKeepMask(distributedGraph, keep);
+
+  if(rank == 0)
+    {
+    // Edges which no rank stores do not exist, so the mask may be shorter than the edge list
+    globalKeep.resize(boost::num_edges(graph), false);
+    WriteGraph(OpenedGraphView(graph, globalKeep), outputFileName);
+    }
+
+  MPI_Finalize();
+  return EXIT_SUCCESS;
+}
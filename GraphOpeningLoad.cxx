@@ -0,0 +1,204 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// This program measures the throughput and latency of a running GraphOpeningServer. Every client thread
+// opens its own connection and sends the same synthetic tree (as an edge list, or as a .dot graph with
+// --format=dot) --requests times, waiting for each reply before sending the next request.
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// C
+#include <unistd.h>
+
+// Boost
+#include <boost/graph/graphviz.hpp>
+
+// Custom
+#include "OpeningProtocol.h"
+#include "OpeningStatistics.h"
+
+// A random tree in which most vertices continue a branch and the rest start a new one, as in Benchmark.
+static void CreateRandomTree(const unsigned int numberOfVertices, std::vector<uint32_t>& sources, std::vector<uint32_t>& targets)
+{
+  srand(0);
+  for(unsigned int v = 1; v < numberOfVertices; ++v)
+    {
+    unsigned int parent = (rand() % 3 == 0) ? rand() % v : v - 1;
+    sources.push_back(parent);
+    targets.push_back(v);
+    }
+}
+
+// The latency below which 'fraction' of the sorted 'latencies' are
+static double GetPercentile(const std::vector<double>& latencies, const double fraction)
+{
+  size_t index = static_cast<size_t>(fraction * (latencies.size() - 1) + 0.5);
+  return latencies[index];
+}
+
+int main(int argc, char *argv[])
+{
+  // Separate the options from the required arguments
+  std::vector<std::string> arguments;
+  unsigned int numberOfClients = 4;
+  unsigned int numberOfRequests = 100;
+  unsigned int numberOfVertices = 100000;
+  unsigned int numberOfIterations = 10;
+  bool sendDOT = false;
+  for(int i = 1; i < argc; ++i)
+    {
+    std::string argument = argv[i];
+    std::stringstream ss(argument.substr(argument.find('=') + 1));
+    if(argument.compare(0, 10, "--clients=") == 0)
+      {
+      ss >> numberOfClients;
+      }
+    else if(argument.compare(0, 11, "--requests=") == 0)
+      {
+      ss >> numberOfRequests;
+      }
+    else if(argument.compare(0, 11, "--vertices=") == 0)
+      {
+      ss >> numberOfVertices;
+      }
+    else if(argument.compare(0, 13, "--iterations=") == 0)
+      {
+      ss >> numberOfIterations;
+      }
+    else if(argument == "--format=dot")
+      {
+      sendDOT = true;
+      }
+    else
+      {
+      arguments.push_back(argument);
+      }
+    }
+
+  // Verify arguments
+  if(arguments.size() < 1 || numberOfClients == 0 || numberOfRequests == 0 || numberOfVertices < 2)
+    {
+    std::cerr << "Required arguments: socketPath [--clients=N] [--requests=N] [--vertices=N] [--iterations=N]"
+              << " [--format=dot]" << std::endl;
+    return -1;
+    }
+  std::string socketPath = arguments[0];
+
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  CreateRandomTree(numberOfVertices, sources, targets);
+
+  OpeningRequest request;
+  request.Algorithm = FixedIterationsAlgorithm;
+  request.Parameter = numberOfIterations;
+  request.Reply = KeepMaskReply;
+  if(sendDOT)
+    {
+    Graph g(numberOfVertices);
+    for(size_t i = 0; i < sources.size(); ++i)
+      {
+      boost::add_edge(sources[i], targets[i], g);
+      }
+    std::stringstream text;
+    boost::write_graphviz(text, g);
+    request.Format = DOTGraphFormat;
+    request.Payload = text.str();
+    }
+  else
+    {
+    EdgeArrays edges = {sources.data(), targets.data(), sources.size()};
+    request.Format = EdgeListGraphFormat;
+    request.Payload = EncodeEdgeList(edges, numberOfVertices);
+    }
+
+  // Output arguments
+  std::cout << "Clients: " << numberOfClients << " Requests per client: " << numberOfRequests
+            << " Edges per request: " << sources.size() << " Format: " << (sendDOT ? "dot" : "edge list") << std::endl;
+
+  std::vector<std::vector<double> > clientLatencies(numberOfClients);
+  std::atomic<unsigned int> numberOfFailures(0);
+  Timer timer;
+  std::vector<std::thread> clients;
+  for(unsigned int i = 0; i < numberOfClients; ++i)
+    {
+    clients.push_back(std::thread([&, i]()
+      {
+      int connection = ConnectToUnixSocket(socketPath);
+      if(connection < 0)
+        {
+        numberOfFailures += numberOfRequests;
+        return;
+        }
+      OpeningReply reply;
+      for(unsigned int r = 0; r < numberOfRequests; ++r)
+        {
+        Timer latency;
+        if(!WriteRequest(connection, request) || !ReadReply(connection, reply))
+          {
+          numberOfFailures += numberOfRequests - r;
+          break;
+          }
+        if(!reply.Succeeded)
+          {
+          numberOfFailures++;
+          continue;
+          }
+        clientLatencies[i].push_back(latency.GetElapsedSeconds());
+        }
+      close(connection);
+      }));
+    }
+  for(unsigned int i = 0; i < clients.size(); ++i)
+    {
+    clients[i].join();
+    }
+  double seconds = timer.GetElapsedSeconds();
+
+  std::vector<double> latencies;
+  for(unsigned int i = 0; i < clientLatencies.size(); ++i)
+    {
+    latencies.insert(latencies.end(), clientLatencies[i].begin(), clientLatencies[i].end());
+    }
+  if(latencies.empty())
+    {
+    std::cerr << "No request succeeded" << std::endl;
+    return -1;
+    }
+  std::sort(latencies.begin(), latencies.end());
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << latencies.size() << " requests in " << seconds << " s: " << latencies.size() / seconds << " requests/s, "
+            << latencies.size() * sources.size() / seconds / 1e6 << " Medges/s" << std::endl;
+  std::cout << std::setprecision(3) << "Latency p50 " << GetPercentile(latencies, 0.5) * 1000 << " ms, p99 "
+            << GetPercentile(latencies, 0.99) * 1000 << " ms, max " << latencies.back() * 1000 << " ms" << std::endl;
+  if(numberOfFailures > 0)
+    {
+    std::cerr << numberOfFailures << " requests failed" << std::endl;
+    return -1;
+    }
+  return EXIT_SUCCESS;
+}
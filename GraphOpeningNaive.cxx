@@ -110,18 +110,27 @@ Graph DilateNaive(const Graph& g, const Graph& parent)
 }
 
 
-Graph OpenGraphFixedNaive(const Graph& g, unsigned int numberOfIterations)
+Graph OpenGraphFixedNaive(const Graph& g, unsigned int numberOfIterations, OpeningStatistics* statistics)
 {
  
   // Initialize the eroded graph to the original graph
   Graph erodedGraph = g;
   
-  
+  Timer timer;
   for(unsigned int i = 0; i < numberOfIterations; ++i)
     {
     std::cout << std::endl << "NaiveErosion " << i << std::endl;
   
+    timer.Restart();
+    unsigned int numberOfEdgesBefore = boost::num_edges(erodedGraph);
     erodedGraph = ErodeNaive(erodedGraph);
+    if(statistics)
+      {
+      // Every end point is searched for again, so the whole graph is the frontier
+      statistics->AddErosion(timer.GetElapsedSeconds(), boost::num_vertices(erodedGraph),
+                             numberOfEdgesBefore - boost::num_edges(erodedGraph));
+      statistics->UpdatePeakWorkspaceBytes(2 * EstimateGraphBytes(erodedGraph));
+      }
     }
     
   // Initialize the dilated graph to the last eroded graph
@@ -130,9 +139,16 @@ Graph OpenGraphFixedNaive(const Graph& g, unsigned int numberOfIterations)
   for(unsigned int i = 0; i < numberOfIterations; ++i)
     {
     std::cout << std::endl << "NaiveDilation " << i << std::endl;
+    timer.Restart();
+    unsigned int numberOfEdgesBefore = boost::num_edges(dilatedGraph);
     dilatedGraph = DilateNaive(dilatedGraph, g);
+    if(statistics)
+      {
+      statistics->AddDilation(timer.GetElapsedSeconds(), boost::num_vertices(dilatedGraph),
+                              boost::num_edges(dilatedGraph) - numberOfEdgesBefore);
+      statistics->UpdatePeakWorkspaceBytes(2 * EstimateGraphBytes(dilatedGraph));
+      }
     }
     
   return dilatedGraph;
 }
-
@@ -26,12 +26,14 @@
 #include <boost/graph/adjacency_list.hpp>
 
 // Custom
+#include "OpeningStatistics.h"
 #include "Types.h"
 
 // This function performs the morphological opening on the graph 'g' a fixed number (numberOfIterations)
 // of times and returns the resulting graph with edges removed. A naive method of finding the end points
-// at every iteration of all erosion and dilation operations is implemented.
-Graph OpenGraphFixedNaive(const Graph& g, unsigned int numberOfIterations);
+// at every iteration of all erosion and dilation operations is implemented. If 'statistics' is not NULL
+// it is filled in with the time and size of every erosion and dilation.
+Graph OpenGraphFixedNaive(const Graph& g, unsigned int numberOfIterations, OpeningStatistics* statistics = NULL);
 
 // Perform a morphological dilation on a graph
 Graph DilateNaive(const Graph& g, const Graph& parent);
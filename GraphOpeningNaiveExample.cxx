@@ -55,7 +55,9 @@ int main(int argc, char *argv[])
   std::cout << "Output: " << outputFileName << std::endl;
   
   // Read the graph
-  Graph graph = ReadGraph(inputFileName);
+  size_t numberOfRemovedEdges = 0;
+  Graph graph = ReadGraph(inputFileName, &numberOfRemovedEdges);
+  std::cout << "Removed " << numberOfRemovedEdges << " self loops and duplicate edges" << std::endl;
 
   Graph openedGraph = OpenGraphFixedNaive(graph, 2);
   
@@ -0,0 +1,198 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "GraphOpeningPeeling.h"
+#include "OpeningEngine.h"
+#include "ParentArrayTree.h"
+
+// Records the vertices of every erosion in a PeelResult, and optionally fills in statistics.
+class PeelRecordingObserver
+{
+public:
+  PeelRecordingObserver(PeelResult& peel, OpeningStatistics* statistics) : Peel(peel), Statistics(statistics) {}
+
+  void Start()
+  {
+    RoundTimer.Restart();
+  }
+
+  void FoundEndPoints(const size_t)
+  {
+    if(Statistics)
+      {
+      Statistics->FindEndPointsSeconds = RoundTimer.GetElapsedSeconds();
+      }
+  }
+
+  void Eroded(const unsigned int, const std::vector<unsigned int>& frontier, const size_t numberOfRemovals,
+              const size_t numberOfEdgesRemoved)
+  {
+    Peel.Order.insert(Peel.Order.end(), frontier.begin(), frontier.end());
+    Peel.RoundOffsets.push_back(Peel.Order.size());
+    Peel.RoundRemovals.push_back(numberOfRemovals);
+    if(Statistics)
+      {
+      Statistics->AddErosion(RoundTimer.GetElapsedSeconds(), frontier.size(), numberOfEdgesRemoved);
+      }
+  }
+
+  void Dilated(const unsigned int, const std::vector<unsigned int>&, const size_t) {}
+
+  void Finished(const size_t) {}
+
+  bool Cancelled() const
+  {
+    return false;
+  }
+
+private:
+  PeelResult& Peel;
+  OpeningStatistics* Statistics;
+  Timer RoundTimer;
+};
+
+PeelResult PeelCompactGraph(const CompactGraph& g, unsigned int degreeThreshold, unsigned int maximumNumberOfRounds,
+                            OpeningStatistics* statistics)
+{
+  PeelResult peel;
+  peel.RoundOffsets.push_back(0);
+
+  OpeningEngine<CompactGraph, ExhaustivePeeling, PeelRecordingObserver> engine;
+  engine.SetDegreeThreshold(degreeThreshold);
+  PeelRecordingObserver observer(peel, statistics);
+  ExhaustivePeeling stopping(maximumNumberOfRounds);
+  engine.Erode(g, stopping, observer);
+
+  peel.VertexRounds = engine.GetVertexRounds();
+  peel.EdgeRounds = engine.GetEdgeRounds();
+
+  if(statistics)
+    {
+    statistics->UpdatePeakWorkspaceBytes(GetAllocatedBytes(g) + GetAllocatedBytes(peel) + engine.GetAllocatedBytes());
+    }
+  return peel;
+}
+
+std::vector<bool> OpenCompactGraphFixed(const CompactGraph& g, unsigned int numberOfIterations, unsigned int degreeThreshold,
+                                        OpeningStatistics* statistics)
+{
+  return OpenWithEngine(g, FixedIterations(numberOfIterations), degreeThreshold, statistics);
+}
+
+std::vector<bool> OpenCompactGraphNullRemovalDifference(const CompactGraph& g, unsigned int goalSuccessiveNullDifferences,
+                                                        unsigned int degreeThreshold, OpeningStatistics* statistics)
+{
+  return OpenWithEngine(g, NullRemovalDifference(goalSuccessiveNullDifferences), degreeThreshold, statistics);
+}
+
+// Open a forest on a ParentArrayTree, which is smaller and faster to build, and any other graph on a
+// CompactGraph. The time to build either is recorded. If 'clean' is set the self loops and duplicate edges
+// are removed first; a forest has neither, so only the other graphs pay for the sort.
+template <typename TStoppingPolicy>
+static std::vector<bool> OpenEdgeArrays(const EdgeArrays& edges, const TStoppingPolicy& stopping,
+                                        const unsigned int degreeThreshold, const bool clean,
+                                        OpeningStatistics* statistics)
+{
+  Timer timer;
+  ParentArrayTree tree;
+  if(CreateParentArrayTree(edges, tree))
+    {
+    if(statistics)
+      {
+      statistics->BuildSeconds = timer.GetElapsedSeconds();
+      }
+    std::vector<bool> keep = OpenWithEngine(tree, stopping, degreeThreshold, statistics);
+    return MapKeepMaskBack(keep, tree, edges);
+    }
+
+  if(clean)
+    {
+    CleanedEdges cleanedEdges = CleanEdgeArrays(edges);
+    if(cleanedEdges.GetNumberOfRemovedEdges() > 0)
+      {
+      CompactGraph compactGraph = CreateCompactGraph(cleanedEdges.GetEdgeArrays());
+      if(statistics)
+        {
+        statistics->BuildSeconds = timer.GetElapsedSeconds();
+        statistics->NumberOfRemovedEdges = cleanedEdges.GetNumberOfRemovedEdges();
+        }
+      std::vector<bool> keep = OpenWithEngine(compactGraph, stopping, degreeThreshold, statistics);
+      return MapKeepMaskBack(keep, cleanedEdges);
+      }
+    }
+
+  CompactGraph compactGraph = CreateCompactGraph(edges);
+  if(statistics)
+    {
+    statistics->BuildSeconds = timer.GetElapsedSeconds();
+    }
+  return OpenWithEngine(compactGraph, stopping, degreeThreshold, statistics);
+}
+
+// The end points of the edges of 'g' in the order of boost::edges(g)
+static void GetEdgeArrays(const Graph& g, std::vector<uint32_t>& sources, std::vector<uint32_t>& targets)
+{
+  sources.clear();
+  targets.clear();
+  sources.reserve(boost::num_edges(g));
+  targets.reserve(boost::num_edges(g));
+  boost::graph_traits<Graph>::edge_iterator edgeIterator, edgeEnd;
+  for(boost::tie(edgeIterator, edgeEnd) = boost::edges(g); edgeIterator != edgeEnd; ++edgeIterator)
+    {
+    sources.push_back(static_cast<uint32_t>(boost::source(*edgeIterator, g)));
+    targets.push_back(static_cast<uint32_t>(boost::target(*edgeIterator, g)));
+    }
+}
+
+Graph OpenGraphFixedPeeling(const Graph& g, unsigned int numberOfIterations, unsigned int degreeThreshold,
+                            OpeningStatistics* statistics)
+{
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  GetEdgeArrays(g, sources, targets);
+  EdgeArrays edges = {sources.data(), targets.data(), sources.size()};
+  std::vector<bool> keep = OpenEdgeArrays(edges, FixedIterations(numberOfIterations), degreeThreshold, false,
+                                          statistics);
+  return CreateGraphFromKeepMask(g, keep);
+}
+
+Graph OpenGraphNullRemovalDifferencePeeling(const Graph& g, unsigned int goalSuccessiveNullDifferences,
+                                            unsigned int degreeThreshold, OpeningStatistics* statistics)
+{
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  GetEdgeArrays(g, sources, targets);
+  EdgeArrays edges = {sources.data(), targets.data(), sources.size()};
+  std::vector<bool> keep = OpenEdgeArrays(edges, NullRemovalDifference(goalSuccessiveNullDifferences), degreeThreshold,
+                                          false, statistics);
+  return CreateGraphFromKeepMask(g, keep);
+}
+
+std::vector<bool> OpenEdgeArraysFixed(const EdgeArrays& edges, unsigned int numberOfIterations, unsigned int degreeThreshold,
+                                      OpeningStatistics* statistics, bool clean)
+{
+  return OpenEdgeArrays(edges, FixedIterations(numberOfIterations), degreeThreshold, clean, statistics);
+}
+
+std::vector<bool> OpenEdgeArraysNullRemovalDifference(const EdgeArrays& edges, unsigned int goalSuccessiveNullDifferences,
+                                                      unsigned int degreeThreshold, OpeningStatistics* statistics,
+                                                      bool clean)
+{
+  return OpenEdgeArrays(edges, NullRemovalDifference(goalSuccessiveNullDifferences), degreeThreshold, clean,
+                        statistics);
+}
@@ -0,0 +1,123 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef GRAPHOPENINGPEELING_H
+#define GRAPHOPENINGPEELING_H
+
+// STL
+#include <vector>
+
+// Custom
+#include "CompactGraph.h"
+#include "OpeningStatistics.h"
+#include "Types.h"
+
+// The generalized erosion removes, in every round, all of the edges attached to a vertex which has
+// between 1 and 'degreeThreshold' neighbors at the start of the round. With degreeThreshold = 1 these
+// are exactly the end points used by ErodeTracking, so the results match OpenGraph*Tracking.
+
+// The result of peeling a graph.
+struct PeelResult
+{
+  // The round (starting at 1) in which each vertex/edge was removed, or 0 if it was never removed.
+  std::vector<unsigned int> VertexRounds;
+  std::vector<unsigned int> EdgeRounds;
+
+  // The peeled vertices in the order they were removed. The vertices of round r
+  // are stored in [RoundOffsets[r-1], RoundOffsets[r]) of Order.
+  std::vector<unsigned int> Order;
+  std::vector<unsigned int> RoundOffsets;
+
+  // The number of removals in each round (starting at index 0 for round 1) as counted by ErodeTracking,
+  // which processes a vertex once for every time it was added to its list of potential end points.
+  std::vector<unsigned int> RoundRemovals;
+
+  unsigned int NumberOfRounds() const
+  {
+    return RoundOffsets.size() - 1;
+  }
+
+  // The number of vertices removed in round r, or 0 if the peeling had stopped before round r.
+  unsigned int FrontierSize(const unsigned int round) const
+  {
+    if(round == 0 || round > NumberOfRounds())
+      {
+      return 0;
+      }
+    return RoundOffsets[round] - RoundOffsets[round - 1];
+  }
+
+  // The number of removals in round r, or 0 if the peeling had stopped before round r.
+  unsigned int NumberOfRemovals(const unsigned int round) const
+  {
+    if(round == 0 || round > NumberOfRounds())
+      {
+      return 0;
+      }
+    return RoundRemovals[round - 1];
+  }
+};
+
+// The number of bytes allocated by a peel result.
+inline size_t GetAllocatedBytes(const PeelResult& peel)
+{
+  return GetAllocatedBytes(peel.VertexRounds) + GetAllocatedBytes(peel.EdgeRounds) + GetAllocatedBytes(peel.Order) +
+         GetAllocatedBytes(peel.RoundOffsets) + GetAllocatedBytes(peel.RoundRemovals);
+}
+
+// Compute the round in which every vertex and edge of 'g' is eroded, in O(V+E). The rounds are used as
+// the buckets of a Batagelj-Zaversnik style bucket queue: the vertices of round r+1 are queued
+// while round r is processed. Peeling stops when nothing more can be removed or after
+// 'maximumNumberOfRounds' rounds (0 means no limit). The opening itself is done by OpeningEngine.
+PeelResult PeelCompactGraph(const CompactGraph& g, unsigned int degreeThreshold, unsigned int maximumNumberOfRounds = 0,
+                            OpeningStatistics* statistics = NULL);
+
+// If 'statistics' is not NULL, the functions below fill it in with the time and size of every round.
+
+// Open 'g' with 'numberOfIterations' erosions and dilations. Returns a keep-mask over the edges of 'g'.
+std::vector<bool> OpenCompactGraphFixed(const CompactGraph& g, unsigned int numberOfIterations,
+                                        unsigned int degreeThreshold = 1, OpeningStatistics* statistics = NULL);
+
+// Open 'g' until the number of removals per erosion has been constant for 'goalSuccessiveNullDifferences'
+// rounds. Returns a keep-mask over the edges of 'g'.
+std::vector<bool> OpenCompactGraphNullRemovalDifference(const CompactGraph& g, unsigned int goalSuccessiveNullDifferences,
+                                                        unsigned int degreeThreshold = 1,
+                                                        OpeningStatistics* statistics = NULL);
+
+// These are equivalent to OpenGraphFixedTracking and OpenGraphNullRemovalDifferenceTracking when degreeThreshold = 1,
+// but run in linear time on a compact copy of the graph: a ParentArrayTree if the graph is a forest, otherwise
+// a CompactGraph.
+Graph OpenGraphFixedPeeling(const Graph& g, unsigned int numberOfIterations, unsigned int degreeThreshold = 1,
+                            OpeningStatistics* statistics = NULL);
+
+Graph OpenGraphNullRemovalDifferencePeeling(const Graph& g, unsigned int goalSuccessiveNullDifferences,
+                                            unsigned int degreeThreshold = 1, OpeningStatistics* statistics = NULL);
+
+// Open a graph given as caller-owned edge arrays without creating a Graph. Only the compact adjacency (a
+// ParentArrayTree for a forest) is built. Returns a keep-mask over the caller's edges: edge i survives the opening if the result[i] is set.
+// Unless 'clean' is false the self loops and duplicate edges are removed first (see CleanEdgeArrays), and their
+// number is stored in the statistics. Every copy of a kept edge is kept, and self loops are not.
+std::vector<bool> OpenEdgeArraysFixed(const EdgeArrays& edges, unsigned int numberOfIterations,
+                                      unsigned int degreeThreshold = 1, OpeningStatistics* statistics = NULL,
+                                      bool clean = true);
+
+std::vector<bool> OpenEdgeArraysNullRemovalDifference(const EdgeArrays& edges, unsigned int goalSuccessiveNullDifferences,
+                                                      unsigned int degreeThreshold = 1,
+                                                      OpeningStatistics* statistics = NULL, bool clean = true);
+
+#endif
@@ -0,0 +1,97 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// This program shows a typical usage. It reads a graph from a file, performs
+// the morphological opening on it, eroding every vertex with at most degreeThreshold
+// neighbors, and then writes the result to a file. With --reorder the vertices are renumbered along
+// the graph before opening it, which is faster for large graphs whose ids are in scan order. Self loops and
+// duplicate edges are removed while reading, so a duplicated leaf edge is still eroded, unless --keep-duplicates is given.
+
+// STL
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Boost
+#include <boost/graph/graphviz.hpp>
+
+// Custom
+#include "GraphOpeningPeeling.h"
+#include "Helpers.h"
+#include "OpenedGraphView.h"
+#include "VertexOrdering.h"
+
+int main(int argc, char *argv[])
+{
+  // Verify arguments
+  if(argc < 5)
+    {
+    std::cerr << "Required arguments: input.dot numberOfIterations degreeThreshold output.dot [--reorder] [--keep-duplicates]" << std::endl;
+    return -1;
+    }
+  
+  // Parse arguments
+  std::string inputFileName = argv[1];
+  
+  unsigned int numberOfIterations = 0;
+  std::stringstream ss(argv[2]);
+  ss >> numberOfIterations;
+  
+  unsigned int degreeThreshold = 0;
+  std::stringstream ssThreshold(argv[3]);
+  ssThreshold >> degreeThreshold;
+
+  std::string outputFileName = argv[4];
+
+  bool reorder = false;
+  bool clean = true;
+  for(int i = 5; i < argc; ++i)
+    {
+    reorder = reorder || std::string(argv[i]) == "--reorder";
+    clean = clean && std::string(argv[i]) != "--keep-duplicates";
+    }
+  
+  // Output arguments
+  std::cout << "Input: " << inputFileName << std::endl;
+  std::cout << "Number of iterations: " << numberOfIterations << std::endl;
+  std::cout << "Degree threshold: " << degreeThreshold << std::endl;
+  std::cout << "Output: " << outputFileName << std::endl;
+  
+  // Read the graph
+  size_t numberOfRemovedEdges = 0;
+  Graph graph = ReadGraph(inputFileName, &numberOfRemovedEdges, clean);
+  std::cout << "Removed " << numberOfRemovedEdges << " self loops and duplicate edges" << std::endl;
+
+  if(reorder)
+    {
+    // Open a renumbered copy and map the result back, so the output has the original ids
+    CompactGraph compactGraph = CreateCompactGraph(graph);
+    GraphReordering reordering = ComputeReordering(compactGraph);
+    std::vector<bool> keep = OpenCompactGraphFixed(ReorderCompactGraph(compactGraph, reordering), numberOfIterations,
+                                                   degreeThreshold);
+    WriteGraph(OpenedGraphView(graph, MapKeepMaskBack(keep, reordering)), outputFileName);
+    return EXIT_SUCCESS;
+    }
+
+  // Only the surviving edges are written, so a view of 'graph' is enough
+  OpenedGraphView openedGraph = OpenGraphFixedView(graph, numberOfIterations, degreeThreshold);
+  
+  WriteGraph(openedGraph, outputFileName);
+  
+  return EXIT_SUCCESS;
+}
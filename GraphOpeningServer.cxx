@@ -0,0 +1,263 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// This program opens graphs for other processes on the same machine, so they do not pay for starting a
+// process and allocating the opening workspace on every graph. It listens on a Unix domain socket and
+// starts a thread per connection which reads its requests (see OpeningProtocol.h); the requests of all
+// connections are opened by a fixed pool of workers. Every worker keeps its opening engines, so after the
+// first few requests their workspace is already allocated. See GraphOpeningClient and GraphOpeningLoad.
+
+// STL
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// C
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Boost
+#include <boost/graph/graphviz.hpp>
+
+// Custom
+#include "BoundedQueue.h"
+#include "CompactGraph.h"
+#include "Helpers.h"
+#include "OpenedGraphView.h"
+#include "OpeningEngine.h"
+#include "OpeningProtocol.h"
+
+// The buffers of one worker, which are reused by all of its requests
+struct Workspace
+{
+  OpeningEngine<CompactGraph, FixedIterations> FixedEngine;
+  OpeningEngine<CompactGraph, NullRemovalDifference> NullRemovalDifferenceEngine;
+  std::vector<bool> Keep;
+};
+
+static void Open(const CompactGraph& g, const OpeningRequest& request, Workspace& workspace)
+{
+  NullObserver observer;
+  if(request.Algorithm == FixedIterationsAlgorithm)
+    {
+    workspace.FixedEngine.SetDegreeThreshold(request.DegreeThreshold);
+    workspace.FixedEngine.Open(g, FixedIterations(request.Parameter), observer, workspace.Keep);
+    }
+  else
+    {
+    workspace.NullRemovalDifferenceEngine.SetDegreeThreshold(request.DegreeThreshold);
+    workspace.NullRemovalDifferenceEngine.Open(g, NullRemovalDifference(request.Parameter), observer, workspace.Keep);
+    }
+}
+
+// A request waiting for a worker. The thread of its connection waits for Done.
+struct Job
+{
+  const OpeningRequest* Request;
+  OpeningReply* Reply;
+  std::promise<void> Done;
+};
+
+// Open the graph of a request and fill in the payload of the reply. Throws if the graph can not be read.
+// The self loops and duplicate edges of the graph are removed first, and their number is returned in
+// 'numberOfRemovedEdges'. The reply describes the remaining edges, in the order of their first occurrence.
+static void HandleRequest(const OpeningRequest& request, Workspace& workspace, OpeningReply& reply,
+                          size_t& numberOfRemovedEdges)
+{
+  if(request.DegreeThreshold == 0)
+    {
+    throw std::runtime_error("the degree threshold must be at least 1");
+    }
+
+  if(request.Format == DOTGraphFormat)
+    {
+    std::stringstream text(request.Payload);
+    Graph graph = ReadGraph(text, &numberOfRemovedEdges);
+    Open(CreateCompactGraph(graph), request, workspace);
+    if(request.Reply == KeepMaskReply)
+      {
+      reply.Payload = EncodeKeepMask(workspace.Keep);
+      }
+    else
+      {
+      OpenedGraphView openedGraph(graph, workspace.Keep);
+      std::stringstream output;
+      boost::write_graphviz(output, openedGraph.GetFilteredGraph());
+      reply.Payload = output.str();
+      }
+    }
+  else
+    {
+    EdgeArrays edges;
+    uint32_t numberOfVertices;
+    if(!DecodeEdgeList(request.Payload, edges, numberOfVertices))
+      {
+      throw std::runtime_error("malformed edge list");
+      }
+    CleanedEdges cleanedEdges = CleanEdgeArrays(edges);
+    numberOfRemovedEdges = cleanedEdges.GetNumberOfRemovedEdges();
+    Open(CreateCompactGraph(cleanedEdges.GetEdgeArrays(), numberOfVertices), request, workspace);
+    if(request.Reply == KeepMaskReply)
+      {
+      reply.Payload = EncodeKeepMask(workspace.Keep);
+      }
+    else
+      {
+      std::vector<uint32_t> sources;
+      std::vector<uint32_t> targets;
+      for(size_t edgeId = 0; edgeId < cleanedEdges.Sources.size(); ++edgeId)
+        {
+        if(workspace.Keep[edgeId])
+          {
+          sources.push_back(cleanedEdges.Sources[edgeId]);
+          targets.push_back(cleanedEdges.Targets[edgeId]);
+          }
+        }
+      EdgeArrays keptEdges = {sources.data(), targets.data(), sources.size()};
+      reply.Payload = EncodeEdgeList(keptEdges, numberOfVertices);
+      }
+    }
+  reply.Succeeded = true;
+}
+
+int main(int argc, char *argv[])
+{
+  // Separate the options from the required arguments
+  std::vector<std::string> arguments;
+  unsigned int numberOfWorkers = std::max(1u, std::thread::hardware_concurrency());
+  for(int i = 1; i < argc; ++i)
+    {
+    std::string argument = argv[i];
+    if(argument.compare(0, 10, "--workers=") == 0)
+      {
+      std::stringstream ss(argument.substr(10));
+      ss >> numberOfWorkers;
+      }
+    else
+      {
+      arguments.push_back(argument);
+      }
+    }
+
+  // Verify arguments
+  if(arguments.size() < 1 || numberOfWorkers == 0)
+    {
+    std::cerr << "Required arguments: socketPath [--workers=N]" << std::endl;
+    return -1;
+    }
+
+  std::string socketPath = arguments[0];
+  int listener = ListenOnUnixSocket(socketPath);
+  if(listener < 0)
+    {
+    std::cerr << "Could not listen on " << socketPath << std::endl;
+    return -1;
+    }
+
+  // Output arguments
+  std::cout << "Listening on " << socketPath << " with " << numberOfWorkers << " workers" << std::endl;
+
+  // Requests waiting for a free worker
+  BoundedQueue<Job> jobs(1024);
+  std::atomic<size_t> numberOfRequests(0);
+
+  std::vector<std::thread> workers;
+  for(unsigned int i = 0; i < numberOfWorkers; ++i)
+    {
+    workers.push_back(std::thread([&]()
+      {
+      Workspace workspace;
+      Job job;
+      while(jobs.Pop(job))
+        {
+        try
+          {
+          size_t numberOfRemovedEdges = 0;
+          HandleRequest(*job.Request, workspace, *job.Reply, numberOfRemovedEdges);
+          if(numberOfRemovedEdges > 0)
+            {
+            // Write the line at once, so the lines of different workers are not mixed up
+            std::stringstream message;
+            message << "Removed " << numberOfRemovedEdges << " self loops and duplicate edges from a request" << std::endl;
+            std::cout << message.str() << std::flush;
+            }
+          }
+        catch(const std::exception& exception)
+          {
+          job.Reply->Succeeded = false;
+          job.Reply->Payload = exception.what();
+          }
+        numberOfRequests++;
+        job.Done.set_value();
+        }
+      }));
+    }
+
+  // The server runs until it is killed
+  while(true)
+    {
+    int connection = accept(listener, NULL, NULL);
+    if(connection < 0)
+      {
+      if(errno == EINTR || errno == ECONNABORTED)
+        {
+        continue;
+        }
+      std::cerr << "Could not accept a connection" << std::endl;
+      break;
+      }
+
+    // A client sends its next request after the reply to the previous one, so a connection only ever
+    // has one request in the queue
+    std::thread([&jobs, connection]()
+      {
+      OpeningRequest request;
+      while(ReadRequest(connection, request))
+        {
+        OpeningReply reply;
+        Job job;
+        job.Request = &request;
+        job.Reply = &reply;
+        std::future<void> done = job.Done.get_future();
+        jobs.Push(std::move(job));
+        done.wait();
+        if(!WriteReply(connection, reply))
+          {
+          break;
+          }
+        }
+      close(connection);
+      }).detach();
+    }
+
+  jobs.Close();
+  for(unsigned int i = 0; i < workers.size(); ++i)
+    {
+    workers[i].join();
+    }
+  close(listener);
+  unlink(socketPath.c_str());
+  std::cout << "Answered " << numberOfRequests << " requests" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -19,119 +19,226 @@
 #include "GraphOpeningTracking.h"
 #include "Helpers.h"
 
-Graph ErodeTracking(const Graph& g, const std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
-                                    std::vector<Graph::vertex_descriptor>& outputPotentialEndPoints)
+// STL
+#include <iostream>
+
+TrackingWorkspace::TrackingWorkspace(const Graph& g) : Adjacency(CreateCompactGraph(g)),
+  IsPresent(Adjacency.NumberOfEdges, true), NumberOfEdges(Adjacency.NumberOfEdges),
+  Degrees(Adjacency.NumberOfVertices), EdgeXors(Adjacency.NumberOfVertices, 0),
+  NeighborXors(Adjacency.NumberOfVertices, 0), DilationStamps(Adjacency.NumberOfVertices, 0), NumberOfDilations(0)
+{
+  for(uint32_t v = 0; v < Adjacency.NumberOfVertices; ++v)
+    {
+    Degrees[v] = Adjacency.Degree(v);
+    Adjacency.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t edgeId)
+      {
+      EdgeXors[v] ^= edgeId;
+      NeighborXors[v] ^= neighbor;
+      });
+    }
+}
+
+void TrackingWorkspace::RemoveEdge(const uint32_t edgeId, const uint32_t v0, const uint32_t v1)
+{
+  IsPresent[edgeId] = false;
+  NumberOfEdges--;
+  Degrees[v0]--;
+  Degrees[v1]--;
+  EdgeXors[v0] ^= edgeId;
+  EdgeXors[v1] ^= edgeId;
+  NeighborXors[v0] ^= v1;
+  NeighborXors[v1] ^= v0;
+}
+
+void TrackingWorkspace::AddEdge(const uint32_t edgeId, const uint32_t v0, const uint32_t v1)
+{
+  IsPresent[edgeId] = true;
+  NumberOfEdges++;
+  Degrees[v0]++;
+  Degrees[v1]++;
+  EdgeXors[v0] ^= edgeId;
+  EdgeXors[v1] ^= edgeId;
+  NeighborXors[v0] ^= v1;
+  NeighborXors[v1] ^= v0;
+}
+
+void TrackingWorkspace::ErodeTracking(const std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
+                                      std::vector<Graph::vertex_descriptor>& outputPotentialEndPoints)
 {
   /*
   Remove all edges attached to an EndPoint
   */
-  Graph eroded = g;
-  std::cout << "g has " << boost::num_vertices(g) << " and eroded has " << boost::num_vertices(eroded) << std::endl;
-  
   outputPotentialEndPoints.clear();
-  
+
   std::cout << "There are " << inputPotentialEndPoints.size() << " end points." << std::endl;
 
-  // Remove edges containing an end point
+  // Find the end points before removing anything, as an end point is judged by the graph at the start of
+  // the round. Both ends of an edge between two end points are reported, and an end point in the list
+  // several times is reported every time.
+  EndPoints.clear();
   for(unsigned int i = 0; i < inputPotentialEndPoints.size(); ++i)
     {
-    if(!IsEndPoint(g, inputPotentialEndPoints[i]))
+    const uint32_t endPoint = inputPotentialEndPoints[i];
+    if(Degrees[endPoint] != 1)
       {
       continue;
       }
     // Get the other vertex attached to the end point
-    std::vector<Graph::vertex_descriptor> neighbors = GetNeighbors(g, inputPotentialEndPoints[i]);
+    const uint32_t neighbor = NeighborXors[endPoint];
 
-    std::cout << "Removing edge between: " << neighbors[0] << " and " << inputPotentialEndPoints[i] << std::endl;
-  
-    boost::remove_edge(neighbors[0],inputPotentialEndPoints[i],eroded);
-    //boost::remove_vertex<>(endPoints[i],eroded); // do not remove the vertex or the name/id of the vertices will change
-    
-    outputPotentialEndPoints.push_back(neighbors[0]);
+    std::cout << "Removing edge between: " << neighbor << " and " << endPoint << std::endl;
+
+    EndPoints.push_back(endPoint);
+    outputPotentialEndPoints.push_back(neighbor);
     }
 
-  //std::cout << "eroded has " << boost::num_vertices(eroded) << std::endl;
-  return eroded;
+  // An end point whose degree dropped to 0 shared its edge with an end point before it in the list
+  for(unsigned int i = 0; i < EndPoints.size(); ++i)
+    {
+    const uint32_t endPoint = EndPoints[i];
+    if(Degrees[endPoint] == 1)
+      {
+      RemoveEdge(EdgeXors[endPoint], endPoint, NeighborXors[endPoint]);
+      }
+    }
 }
 
-Graph DilateTracking(const Graph& g, const Graph& parent, 
-                     const std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
-                     std::vector<Graph::vertex_descriptor>& outputPotentialEndPoints)
+void TrackingWorkspace::DilateTracking(const std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
+                                       std::vector<Graph::vertex_descriptor>& outputPotentialEndPoints)
 {
   /*
  Add back an edge to every end point
  */
-  
-  Graph dilated = g;
-
   outputPotentialEndPoints.clear();
-  
-  // Add back edges that were removed
+
+  // Again the end points are judged by the graph at the start of the round. Once an end point has been
+  // processed all of its edges are present, so it is only processed the first time it is in the list.
+  NumberOfDilations++;
+  EndPoints.clear();
   for(unsigned int i = 0; i < inputPotentialEndPoints.size(); ++i)
     {
-    if(!IsEndPoint(g, inputPotentialEndPoints[i]))
+    const uint32_t endPoint = inputPotentialEndPoints[i];
+    if(Degrees[endPoint] != 1 || DilationStamps[endPoint] == NumberOfDilations)
       {
       continue;
       }
-    // Get attached vertices in parent graph
-    std::vector<Graph::vertex_descriptor> neighbors = GetNeighbors(parent, inputPotentialEndPoints[i]);
-    
-    for(unsigned int neighbor = 0; neighbor < neighbors.size(); neighbor++)
+    DilationStamps[endPoint] = NumberOfDilations;
+    EndPoints.push_back(endPoint);
+    }
+
+  // Add back edges that were removed
+  for(unsigned int i = 0; i < EndPoints.size(); ++i)
+    {
+    const uint32_t endPoint = EndPoints[i];
+    Adjacency.ForEachNeighbor(endPoint, [&](const uint32_t neighbor, const uint32_t edgeId)
       {
-      // Check to make sure this edge doesn't already exist (i.e that it is the one that is causing this to be an end point)
-      if(EdgeExists(dilated, neighbors[neighbor], inputPotentialEndPoints[i]))
-	{
-	//std::cout << "Edge between: " << neighbors[neighbor] << " and " << endPoints[i] << " already exists!" << std::endl;
-	continue;
-	}
-      boost::add_edge(neighbors[neighbor], inputPotentialEndPoints[i], dilated);
-      std::cout << "Adding edge between: " << neighbors[neighbor] << " and " << inputPotentialEndPoints[i] << std::endl;
-      outputPotentialEndPoints.push_back(neighbors[neighbor]);
-      } // end loop over neighbors
-  
-    } // end loop over endpoints
+      // Skip the edge which is causing this to be an end point, and the edges already added back this round
+      if(IsPresent[edgeId])
+        {
+        return;
+        }
+      AddEdge(edgeId, endPoint, neighbor);
+      std::cout << "Adding edge between: " << neighbor << " and " << endPoint << std::endl;
+      outputPotentialEndPoints.push_back(neighbor);
+      });
+    }
+}
 
-  //std::cout << "dilated has " << boost::num_vertices(dilated) << std::endl;
-  return dilated;
+size_t TrackingWorkspace::GetAllocatedBytes() const
+{
+  return ::GetAllocatedBytes(Adjacency) + ::GetAllocatedBytes(IsPresent) + ::GetAllocatedBytes(Degrees) +
+         ::GetAllocatedBytes(EdgeXors) + ::GetAllocatedBytes(NeighborXors) + ::GetAllocatedBytes(EndPoints) +
+         ::GetAllocatedBytes(DilationStamps);
 }
 
+// The memory used by the opening: the workspace and the end point lists
+static size_t GetTrackingWorkspaceBytes(const TrackingWorkspace& workspace,
+                                        const std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
+                                        const std::vector<Graph::vertex_descriptor>& outputPotentialEndPoints)
+{
+  return workspace.GetAllocatedBytes() + GetAllocatedBytes(inputPotentialEndPoints) +
+         GetAllocatedBytes(outputPotentialEndPoints);
+}
 
-Graph OpenGraphFixedTracking(const Graph& g, unsigned int numberOfIterations)
+// Dilate the result of the erosions of 'workspace' 'numberOfIterations' times, starting with the end points
+// found by the last erosion, and create the opened graph.
+static Graph DilateTracking(const Graph& g, TrackingWorkspace& workspace, unsigned int numberOfIterations,
+                            std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
+                            OpeningStatistics* statistics)
 {
-  // Initialize the eroded graph to the original graph
-  Graph erodedGraph = g;
-  
-  std::vector<Graph::vertex_descriptor> inputPotentialEndPoints = FindEndPoints(g);
   std::vector<Graph::vertex_descriptor> outputPotentialEndPoints;
-  
+  Timer timer;
   for(unsigned int i = 0; i < numberOfIterations; ++i)
     {
-    std::cout << std::endl << "TrackingErosion " << i << std::endl;
-  
-    erodedGraph = ErodeTracking(erodedGraph, inputPotentialEndPoints, outputPotentialEndPoints);
-    inputPotentialEndPoints = outputPotentialEndPoints;
+    std::cout << std::endl << "TrackingDilation " << i << std::endl;
+    timer.Restart();
+    unsigned int numberOfEdgesBefore = workspace.GetNumberOfEdges();
+    unsigned int frontierSize = inputPotentialEndPoints.size();
+    workspace.DilateTracking(inputPotentialEndPoints, outputPotentialEndPoints);
+    if(statistics)
+      {
+      statistics->AddDilation(timer.GetElapsedSeconds(), frontierSize, workspace.GetNumberOfEdges() - numberOfEdgesBefore);
+      statistics->UpdatePeakWorkspaceBytes(GetTrackingWorkspaceBytes(workspace, inputPotentialEndPoints, outputPotentialEndPoints));
+      }
+    inputPotentialEndPoints.swap(outputPotentialEndPoints);
+    }
+
+  return CreateGraphFromKeepMask(g, workspace.GetKeepMask());
+}
+
+Graph OpenGraphFixedTracking(const Graph& g, unsigned int numberOfIterations, OpeningStatistics* statistics)
+{
+  Timer timer;
+  TrackingWorkspace workspace(g);
+  if(statistics)
+    {
+    statistics->BuildSeconds = timer.GetElapsedSeconds();
+    }
+
+  timer.Restart();
+  std::vector<Graph::vertex_descriptor> inputPotentialEndPoints = FindEndPoints(g);
+  std::vector<Graph::vertex_descriptor> outputPotentialEndPoints;
+  if(statistics)
+    {
+    statistics->FindEndPointsSeconds = timer.GetElapsedSeconds();
     }
-    
-  // Initialize the dilated graph to the last eroded graph
-  Graph dilatedGraph = erodedGraph;
   
   for(unsigned int i = 0; i < numberOfIterations; ++i)
     {
-    std::cout << std::endl << "TrackingDilation " << i << std::endl;
-    dilatedGraph = DilateTracking(dilatedGraph, g, inputPotentialEndPoints, outputPotentialEndPoints);
-    inputPotentialEndPoints = outputPotentialEndPoints;
+    std::cout << std::endl << "TrackingErosion " << i << std::endl;
+  
+    timer.Restart();
+    unsigned int numberOfEdgesBefore = workspace.GetNumberOfEdges();
+    unsigned int frontierSize = inputPotentialEndPoints.size();
+    workspace.ErodeTracking(inputPotentialEndPoints, outputPotentialEndPoints);
+    if(statistics)
+      {
+      statistics->AddErosion(timer.GetElapsedSeconds(), frontierSize, numberOfEdgesBefore - workspace.GetNumberOfEdges());
+      statistics->UpdatePeakWorkspaceBytes(GetTrackingWorkspaceBytes(workspace, inputPotentialEndPoints, outputPotentialEndPoints));
+      }
+    inputPotentialEndPoints.swap(outputPotentialEndPoints);
     }
     
-  return dilatedGraph;
+  return DilateTracking(g, workspace, numberOfIterations, inputPotentialEndPoints, statistics);
 }
 
-Graph OpenGraphNullRemovalDifferenceTracking(const Graph& g, unsigned int goalSuccessiveNullDifferences)
+Graph OpenGraphNullRemovalDifferenceTracking(const Graph& g, unsigned int goalSuccessiveNullDifferences,
+                                             OpeningStatistics* statistics)
 {
-  // Initialize the eroded graph to the original graph
-  Graph erodedGraph = g;
-  
+  Timer timer;
+  TrackingWorkspace workspace(g);
+  if(statistics)
+    {
+    statistics->BuildSeconds = timer.GetElapsedSeconds();
+    }
+
+  timer.Restart();
   std::vector<Graph::vertex_descriptor> inputPotentialEndPoints = FindEndPoints(g);
   std::vector<Graph::vertex_descriptor> outputPotentialEndPoints;
+  if(statistics)
+    {
+    statistics->FindEndPointsSeconds = timer.GetElapsedSeconds();
+    }
   
   unsigned int numberOfErosions = 0;
   unsigned int numberOfSuccessiveNullDifferences = 0;
@@ -140,10 +247,18 @@ Graph OpenGraphNullRemovalDifferenceTracking(const Graph& g, unsigned int goalSu
     {
     std::cout << std::endl << "TrackingErosion " << numberOfErosions << std::endl;
   
-    erodedGraph = ErodeTracking(erodedGraph, inputPotentialEndPoints, outputPotentialEndPoints);
-    inputPotentialEndPoints = outputPotentialEndPoints;
+    timer.Restart();
+    unsigned int numberOfEdgesBefore = workspace.GetNumberOfEdges();
+    unsigned int frontierSize = inputPotentialEndPoints.size();
+    workspace.ErodeTracking(inputPotentialEndPoints, outputPotentialEndPoints);
+    if(statistics)
+      {
+      statistics->AddErosion(timer.GetElapsedSeconds(), frontierSize, numberOfEdgesBefore - workspace.GetNumberOfEdges());
+      statistics->UpdatePeakWorkspaceBytes(GetTrackingWorkspaceBytes(workspace, inputPotentialEndPoints, outputPotentialEndPoints));
+      }
+    inputPotentialEndPoints.swap(outputPotentialEndPoints);
   
-    unsigned int numberOfEdgesRemoved = outputPotentialEndPoints.size();
+    unsigned int numberOfEdgesRemoved = inputPotentialEndPoints.size();
     
     if(numberOfEdgesRemoved == numberOfEdgesPreviouslyRemoved)
       {
@@ -159,15 +274,5 @@ Graph OpenGraphNullRemovalDifferenceTracking(const Graph& g, unsigned int goalSu
     numberOfErosions++;
     }
     
-  // Initialize the dilated graph to the last eroded graph
-  Graph dilatedGraph = erodedGraph;
-  
-  for(unsigned int i = 0; i < numberOfErosions; ++i)
-    {
-    std::cout << std::endl << "TrackingDilation " << i << std::endl;
-    dilatedGraph = DilateTracking(dilatedGraph, g, inputPotentialEndPoints, outputPotentialEndPoints);
-    inputPotentialEndPoints = outputPotentialEndPoints;
-    }
-    
-  return dilatedGraph;
+  return DilateTracking(g, workspace, numberOfErosions, inputPotentialEndPoints, statistics);
 }
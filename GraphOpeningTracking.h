@@ -19,27 +19,80 @@
 #ifndef GRAPHOPENINGTRACKING_H
 #define GRAPHOPENINGTRACKING_H
 
+// STL
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "CompactGraph.h"
+#include "OpeningStatistics.h"
 #include "Types.h"
 
-// Perform a morphological dilation on a graph
-Graph DilateTracking(const Graph& g, const Graph& parent,
-                     const std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
+// The state of a tracking opening of a graph 'g'. The graph itself is never copied or modified: every edge
+// of 'g' only has a flag telling whether it is currently present, and every vertex keeps its current degree.
+// An erosion or dilation therefore only costs time proportional to its lists of potential end points
+// and the edges of the end points it processes, even at a hub with many leaves.
+class TrackingWorkspace
+{
+public:
+  explicit TrackingWorkspace(const Graph& g);
+
+  // Perform a morphological erosion on the current graph
+  void ErodeTracking(const std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
                      std::vector<Graph::vertex_descriptor>& outputPotentialEndPoints);
 
-// Perform a morphological erosion on a graph
-Graph ErodeTracking(const Graph& g, const std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
-                                    std::vector<Graph::vertex_descriptor>& outputPotentialEndPoints);
+  // Perform a morphological dilation on the current graph, adding back edges of 'g'
+  void DilateTracking(const std::vector<Graph::vertex_descriptor>& inputPotentialEndPoints,
+                      std::vector<Graph::vertex_descriptor>& outputPotentialEndPoints);
+
+  unsigned int GetNumberOfEdges() const
+  {
+    return NumberOfEdges;
+  }
+
+  // Whether each edge of 'g' (in the order of boost::edges()) is in the current graph,
+  // see CreateGraphFromKeepMask.
+  const std::vector<bool>& GetKeepMask() const
+  {
+    return IsPresent;
+  }
+
+  size_t GetAllocatedBytes() const;
+
+private:
+  void RemoveEdge(const uint32_t edgeId, const uint32_t v0, const uint32_t v1);
+  void AddEdge(const uint32_t edgeId, const uint32_t v0, const uint32_t v1);
+
+  CompactGraph Adjacency;
+  std::vector<bool> IsPresent;
+  unsigned int NumberOfEdges;
+
+  // The degree of every vertex in the current graph, and the XOR of the ids of its present edges and
+  // of its neighbors. At an end point these are the id of its only edge and its only neighbor.
+  std::vector<uint32_t> Degrees;
+  std::vector<uint32_t> EdgeXors;
+  std::vector<uint32_t> NeighborXors;
+
+  // The end points of the current round, and the last dilation in which each vertex was processed
+  std::vector<uint32_t> EndPoints;
+  std::vector<uint32_t> DilationStamps;
+  uint32_t NumberOfDilations;
+};
 
+// If 'statistics' is not NULL, the opening functions below fill it in with the time and size of every erosion and dilation.
 
 // This function performs the morphological opening on the graph 'g' a fixed number (numberOfIterations)
 // of times and returns the resulting graph with edges removed. The end points are tracked after each
 // erosion and dilation operation so that an exhaustive search is only necessary at the beginning.
-Graph OpenGraphFixedTracking(const Graph& g, unsigned int numberOfIterations);
+Graph OpenGraphFixedTracking(const Graph& g, unsigned int numberOfIterations, OpeningStatistics* statistics = NULL);
 
 // This function performs the morphological opening on the graph 'g' until the number of edges removed in
 // 'goalSuccessiveNullDifferences' successive iterations is constant (the difference between the number of edges removed
 // in successive iterations is 0). The end points are tracked after each erosion and dilation operation so that
 // an exhaustive search is only necessary at the beginning.
-Graph OpenGraphNullRemovalDifferenceTracking(const Graph& g, unsigned int goalSuccessiveNullDifferences);
+Graph OpenGraphNullRemovalDifferenceTracking(const Graph& g, unsigned int goalSuccessiveNullDifferences,
+                                             OpeningStatistics* statistics = NULL);
 
 #endif
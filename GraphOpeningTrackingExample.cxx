@@ -17,12 +17,14 @@
  *=========================================================================*/
 
 // This program shows a typical usage. It reads a graph from a file, performs
-// the morphological opening on it, and then writes the result to a file.
+// the morphological opening on it, and then writes the result to a file. With --stats=json the
+// timings and counters of every phase are written to output.dot.stats.json.
 
 // STL
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 // Boost
 #include <boost/graph/graphviz.hpp>
@@ -33,33 +35,69 @@
 
 int main(int argc, char *argv[])
 {
+  // Separate the options from the required arguments
+  std::vector<std::string> arguments;
+  bool writeStatistics = false;
+  for(int i = 1; i < argc; ++i)
+    {
+    std::string argument = argv[i];
+    if(argument == "--stats=json")
+      {
+      writeStatistics = true;
+      }
+    else if(argument.compare(0, 8, "--stats=") == 0)
+      {
+      std::cerr << "Unsupported statistics format: " << argument.substr(8) << " (only json is supported)" << std::endl;
+      return -1;
+      }
+    else
+      {
+      arguments.push_back(argument);
+      }
+    }
+
   // Verify arguments
-  if(argc < 4)
+  if(arguments.size() < 3)
     {
-    std::cerr << "Required arguments: input.dot numberOfIterations output.dot" << std::endl;
+    std::cerr << "Required arguments: input.dot numberOfIterations output.dot [--stats=json]" << std::endl;
     return -1;
     }
   
   // Parse arguments
-  std::string inputFileName = argv[1];
+  std::string inputFileName = arguments[0];
   
   unsigned int numberOfIterations = 0;
-  std::stringstream ss(argv[2]);
+  std::stringstream ss(arguments[1]);
   ss >> numberOfIterations;
   
-  std::string outputFileName = argv[3];
+  std::string outputFileName = arguments[2];
   
   // Output arguments
   std::cout << "Input: " << inputFileName << std::endl;
   std::cout << "Number of iterations: " << numberOfIterations << std::endl;
   std::cout << "Output: " << outputFileName << std::endl;
   
+  OpeningStatistics statistics;
+  OpeningStatistics* statisticsPointer = writeStatistics ? &statistics : NULL;
+
   // Read the graph
-  Graph graph = ReadGraph(inputFileName);
+  Timer timer;
+  Graph graph = ReadGraph(inputFileName, &statistics.NumberOfRemovedEdges);
+  statistics.LoadSeconds = timer.GetElapsedSeconds();
+  std::cout << "Removed " << statistics.NumberOfRemovedEdges << " self loops and duplicate edges" << std::endl;
 
-  Graph openedGraph = OpenGraphFixedTracking(graph, numberOfIterations);
+  Graph openedGraph = OpenGraphFixedTracking(graph, numberOfIterations, statisticsPointer);
   
+  timer.Restart();
   WriteGraph(openedGraph, outputFileName);
+  statistics.WriteSeconds = timer.GetElapsedSeconds();
   
+  if(writeStatistics)
+    {
+    std::string statisticsFileName = outputFileName + ".stats.json";
+    WriteStatisticsJSON(statistics, statisticsFileName);
+    std::cout << "Statistics: " << statisticsFileName << std::endl;
+    }
+
   return EXIT_SUCCESS;
 }
@@ -18,9 +18,12 @@
 
 // Custom
 #include "Helpers.h"
+#include "CompactGraph.h"
 
 // STL
+#include <algorithm>
 #include <fstream>
+#include <stdexcept>
 
 // Boost
 #include <boost/graph/graphviz.hpp> // For writing graphs to a file
@@ -109,7 +112,13 @@ void WriteGraphWithVisibility(const Graph& inputGraph, const std::string& fileNa
   boost::write_graphviz_dp(fout, g, dp);
 }
 
-Graph ReadGraph(const std::string& fileName)
+Graph ReadGraph(const std::string& fileName, size_t* numberOfRemovedEdges, bool clean)
+{
+  std::ifstream fin(fileName.c_str());
+  return ReadGraph(fin, numberOfRemovedEdges, clean);
+}
+
+Graph ReadGraph(std::istream& stream, size_t* numberOfRemovedEdges, bool clean)
 {
   // Create a graph type with a vertex property to store the id of the vertices in the graphviz file
   typedef boost::property < boost::vertex_name_t, std::string> VertexProperty;
@@ -123,8 +132,7 @@ Graph ReadGraph(const std::string& fileName)
     get(boost::vertex_name, graphFromFile);
   dp.property("node_id",name);
   
-  std::ifstream fin(fileName.c_str());
-  boost::read_graphviz(fin, graphFromFile, dp);
+  boost::read_graphviz(stream, graphFromFile, dp);
 
   // Create a property_map of the input vertex ids
   boost::property_map<GraphFromFile, boost::vertex_name_t>::type value = boost::get(boost::vertex_name_t(), graphFromFile);
@@ -151,9 +159,50 @@ Graph ReadGraph(const std::string& fileName)
     {
     graph[*iterator].visible = true;
     }
+
+  // CleanGraph indexes the edges again if it removes any
+  IndexEdges(graph);
+  size_t numberOfCleanedEdges = clean ? CleanGraph(graph) : 0;
+  if(numberOfRemovedEdges)
+    {
+    *numberOfRemovedEdges = numberOfCleanedEdges;
+    }
   return graph;
 }
 
+void IndexEdges(Graph& g)
+{
+  unsigned int index = 0;
+  std::pair<Graph::edge_iterator, Graph::edge_iterator> edgeRange = boost::edges(g);
+  for(Graph::edge_iterator iterator = edgeRange.first; iterator != edgeRange.second; ++iterator)
+    {
+    g[*iterator].Index = index;
+    index++;
+    }
+}
+
+EdgePositionMap::EdgePositionMap(const Graph& g)
+{
+  Positions.reserve(boost::num_edges(g));
+  std::pair<Graph::edge_iterator, Graph::edge_iterator> edgeRange = boost::edges(g);
+  for(Graph::edge_iterator iterator = edgeRange.first; iterator != edgeRange.second; ++iterator)
+    {
+    Positions.push_back(std::make_pair(static_cast<const EdgeVisibility*>(iterator->get_property()), Positions.size()));
+    }
+  std::sort(Positions.begin(), Positions.end());
+}
+
+size_t EdgePositionMap::operator[](const Graph::edge_descriptor& e) const
+{
+  const EdgeVisibility* property = static_cast<const EdgeVisibility*>(e.get_property());
+  std::vector<std::pair<const EdgeVisibility*, size_t> >::const_iterator position =
+    std::lower_bound(Positions.begin(), Positions.end(), std::make_pair(property, static_cast<size_t>(0)));
+  if(position == Positions.end() || position->first != property)
+    {
+    throw std::out_of_range("the edge is not in the graph of the EdgePositionMap");
+    }
+  return position->second;
+}
 
 void OutputEdges(const Graph& g)
 {
@@ -206,6 +255,16 @@ unsigned int CountInvisibleEdges(const Graph g)
   return numberOfInvisibleEdges;
 }
 
+size_t EstimateGraphBytes(const Graph& g)
+{
+  // Every vertex stores a vector of out edges. Every edge is a node in the global edge list
+  // (two pointers, both end points and the property) and appears in the out edge vector of both end points.
+  size_t bytesPerVertex = sizeof(Graph::stored_vertex);
+  size_t bytesPerEdge = 2 * sizeof(void*) + 2 * sizeof(Graph::vertex_descriptor) + sizeof(EdgeVisibility) +
+                        2 * (sizeof(Graph::vertex_descriptor) + sizeof(void*));
+  return boost::num_vertices(g) * bytesPerVertex + boost::num_edges(g) * bytesPerEdge;
+}
+
 void OutputEdgeVisibility(const Graph g)
 {
   // Iterate over all of the edges of the original graph.
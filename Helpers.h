@@ -23,6 +23,8 @@
 #include "Types.h"
 
 // STL
+#include <iostream>
+#include <utility>
 #include <vector>
 
 // Get a list of the vertices in the graph which are end points.
@@ -52,11 +54,47 @@ void WriteGraph(const Graph& g, const std::string& fileName);
 // Write a graph to a file, possible with invisible edges
 void WriteGraphWithVisibility(const Graph& g, const std::string& fileName);
 
-// Read a graph from a .dot file.
-Graph ReadGraph(const std::string& fileName);
+// Read a graph from a .dot file. The edges are visible and indexed. Unless 'clean' is false, the self loops
+// and duplicate edges are removed (see CleanGraph) and their number is stored in 'numberOfRemovedEdges'.
+Graph ReadGraph(const std::string& fileName, size_t* numberOfRemovedEdges = NULL, bool clean = true);
+
+// Read a graph from a stream holding a single .dot graph.
+Graph ReadGraph(std::istream& stream, size_t* numberOfRemovedEdges = NULL, bool clean = true);
+
+// Set the Index of every edge to its position in boost::edges(g).
+void IndexEdges(Graph& g);
+
+// A readable property map from every edge of a graph to its position in boost::edges(). Unlike
+// EdgeVisibility::Index it is right whether or not the graph was indexed, but it must be created again
+// after edges are added to or removed from the graph.
+class EdgePositionMap
+{
+public:
+  typedef Graph::edge_descriptor key_type;
+  typedef size_t value_type;
+  typedef size_t reference;
+  typedef boost::readable_property_map_tag category;
+
+  explicit EdgePositionMap(const Graph& g);
+
+  // Throws std::out_of_range if 'e' is not an edge of the graph the map was created from.
+  size_t operator[](const Graph::edge_descriptor& e) const;
+
+private:
+  // The address of the property of every edge, which identifies the edge, and its position, sorted by address
+  std::vector<std::pair<const EdgeVisibility*, size_t> > Positions;
+};
+
+inline size_t get(const EdgePositionMap& map, const Graph::edge_descriptor& e)
+{
+  return map[e];
+}
 
 unsigned int CountInvisibleEdges(const Graph g);
 
+// Estimate the number of bytes of memory used by the vertices and edges of a graph.
+size_t EstimateGraphBytes(const Graph& g);
+
 void OutputEdgeVisibility(const Graph g);
 
 // Output all of the elements of a vector, space delimited.
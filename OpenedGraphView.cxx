@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "OpenedGraphView.h"
+
+// STL
+#include <fstream>
+#include <stdexcept>
+
+// Boost
+#include <boost/graph/graphviz.hpp>
+#include <boost/property_map/function_property_map.hpp>
+
+// Custom
+#include "CompactGraph.h"
+#include "GraphOpeningPeeling.h"
+
+OpenedGraphView::OpenedGraphView(const Graph& g, std::vector<bool> keep) : OriginalGraph(&g), Positions(g),
+  NumberOfKeptEdges(0)
+{
+  if(keep.size() != boost::num_edges(g))
+    {
+    throw std::invalid_argument("the keep-mask must have one entry for every edge of the graph");
+    }
+  Keep.swap(keep);
+  for(size_t edgeId = 0; edgeId < Keep.size(); ++edgeId)
+    {
+    if(Keep[edgeId])
+      {
+      NumberOfKeptEdges++;
+      }
+    }
+}
+
+std::pair<KeptEdgeIterator, KeptEdgeIterator> OpenedGraphView::GetKeptEdges() const
+{
+  std::pair<Graph::edge_iterator, Graph::edge_iterator> edgeRange = boost::edges(*OriginalGraph);
+  return std::make_pair(KeptEdgeIterator(GetPredicate(), edgeRange.first, edgeRange.second),
+                        KeptEdgeIterator(GetPredicate(), edgeRange.second, edgeRange.second));
+}
+
+OpenedGraphView OpenGraphFixedView(const Graph& g, unsigned int numberOfIterations, unsigned int degreeThreshold,
+                                   OpeningStatistics* statistics)
+{
+  Timer timer;
+  CompactGraph compactGraph = CreateCompactGraph(g);
+  if(statistics)
+    {
+    statistics->BuildSeconds = timer.GetElapsedSeconds();
+    }
+  return OpenedGraphView(
+    g, OpenCompactGraphFixed(compactGraph, numberOfIterations, degreeThreshold, statistics));
+}
+
+OpenedGraphView OpenGraphNullRemovalDifferenceView(const Graph& g, unsigned int goalSuccessiveNullDifferences,
+                                                   unsigned int degreeThreshold, OpeningStatistics* statistics)
+{
+  Timer timer;
+  CompactGraph compactGraph = CreateCompactGraph(g);
+  if(statistics)
+    {
+    statistics->BuildSeconds = timer.GetElapsedSeconds();
+    }
+  return OpenedGraphView(
+    g, OpenCompactGraphNullRemovalDifference(compactGraph, goalSuccessiveNullDifferences, degreeThreshold, statistics));
+}
+
+void WriteGraph(const OpenedGraphView& view, const std::string& fileName)
+{
+  std::ofstream fout(fileName.c_str());
+  boost::write_graphviz(fout, view.GetFilteredGraph());
+}
+
+// The graphviz style of an edge of the view
+struct EdgeStyle
+{
+  typedef std::string result_type;
+
+  explicit EdgeStyle(const OpenedGraphView* view) : View(view) {}
+
+  std::string operator()(const Graph::edge_descriptor& e) const
+  {
+    return View->IsKept(e) ? "normal" : "invis";
+  }
+
+  const OpenedGraphView* View;
+};
+
+void WriteGraphWithVisibility(const OpenedGraphView& view, const std::string& fileName)
+{
+  const Graph& g = view.GetOriginalGraph();
+  boost::dynamic_properties dp;
+  dp.property("style", boost::make_function_property_map<Graph::edge_descriptor>(EdgeStyle(&view)));
+  dp.property("node_id", get(boost::vertex_index, g));
+
+  std::ofstream fout(fileName.c_str());
+  boost::write_graphviz_dp(fout, g, dp);
+}
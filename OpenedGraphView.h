@@ -0,0 +1,122 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef OPENEDGRAPHVIEW_H
+#define OPENEDGRAPHVIEW_H
+
+// STL
+#include <string>
+#include <utility>
+#include <vector>
+
+// Boost
+#include <boost/graph/filtered_graph.hpp>
+#include <boost/iterator/filter_iterator.hpp>
+
+// Custom
+#include "Helpers.h"
+#include "OpeningStatistics.h"
+#include "Types.h"
+
+// Selects the edges of a graph whose position in boost::edges() is set in a keep-mask.
+struct KeepMaskEdgePredicate
+{
+  KeepMaskEdgePredicate() : Positions(NULL), Keep(NULL) {}
+  KeepMaskEdgePredicate(const EdgePositionMap* positions, const std::vector<bool>* keep) : Positions(positions), Keep(keep) {}
+
+  bool operator()(const Graph::edge_descriptor& e) const
+  {
+    return (*Keep)[(*Positions)[e]];
+  }
+
+  const EdgePositionMap* Positions;
+  const std::vector<bool>* Keep;
+};
+
+typedef boost::filtered_graph<Graph, KeepMaskEdgePredicate> FilteredGraph;
+
+// Iterates over the edges of the original graph which survived the opening.
+typedef boost::filter_iterator<KeepMaskEdgePredicate, Graph::edge_iterator> KeptEdgeIterator;
+
+// The result of an opening as the original graph plus one bit per edge, instead of a copy of the graph.
+// The keep-mask is in the order of boost::edges(g), such as the result of OpenCompactGraphFixed on
+// CreateCompactGraph(g). The edges are found by their position, so EdgeVisibility::Index is not used.
+// The original graph must outlive the view and must not be changed, and the view must outlive the
+// filtered graphs and iterators it hands out.
+class OpenedGraphView
+{
+public:
+  // Throws std::invalid_argument if 'keep' does not have one entry for every edge of 'g'.
+  OpenedGraphView(const Graph& g, std::vector<bool> keep);
+
+  const Graph& GetOriginalGraph() const
+  {
+    return *OriginalGraph;
+  }
+
+  // The keep-mask, in the order of boost::edges().
+  const std::vector<bool>& GetKeepMask() const
+  {
+    return Keep;
+  }
+
+  bool IsKept(const Graph::edge_descriptor& e) const
+  {
+    return Keep[Positions[e]];
+  }
+
+  size_t GetNumberOfKeptEdges() const
+  {
+    return NumberOfKeptEdges;
+  }
+
+  // A BGL graph with all of the vertices of the original graph and only the kept edges.
+  FilteredGraph GetFilteredGraph() const
+  {
+    return FilteredGraph(*OriginalGraph, GetPredicate());
+  }
+
+  std::pair<KeptEdgeIterator, KeptEdgeIterator> GetKeptEdges() const;
+
+private:
+  KeepMaskEdgePredicate GetPredicate() const
+  {
+    return KeepMaskEdgePredicate(&Positions, &Keep);
+  }
+
+  const Graph* OriginalGraph;
+  EdgePositionMap Positions;
+  std::vector<bool> Keep;
+  size_t NumberOfKeptEdges;
+};
+
+// These are equivalent to OpenGraphFixedPeeling and OpenGraphNullRemovalDifferencePeeling,
+// but return a view of 'g' instead of a new Graph.
+OpenedGraphView OpenGraphFixedView(const Graph& g, unsigned int numberOfIterations, unsigned int degreeThreshold = 1,
+                                   OpeningStatistics* statistics = NULL);
+
+OpenedGraphView OpenGraphNullRemovalDifferenceView(const Graph& g, unsigned int goalSuccessiveNullDifferences,
+                                                   unsigned int degreeThreshold = 1, OpeningStatistics* statistics = NULL);
+
+// Write only the kept edges to a file.
+void WriteGraph(const OpenedGraphView& view, const std::string& fileName);
+
+// Write all of the edges of the original graph to a file, with the removed edges marked as invisible.
+void WriteGraphWithVisibility(const OpenedGraphView& view, const std::string& fileName);
+
+#endif
@@ -0,0 +1,302 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "OpeningCache.h"
+
+// STL
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+// C
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+// Custom
+#include "CompactGraph.h"
+#include "GraphOpeningPeeling.h"
+
+////////////////////// Keys //////////////////////
+
+// One step of a simple multiply-rotate hash of 64 bit words
+static uint64_t HashWord(uint64_t hash, const uint64_t word)
+{
+  hash ^= word * 0x9e3779b97f4a7c15ULL;
+  hash = (hash << 27) | (hash >> 37);
+  return hash * 0xc2b2ae3d27d4eb4fULL + 0x165667b19e3779f9ULL;
+}
+
+// Spread the bits of the final hash (the finalizer of MurmurHash3)
+static uint64_t FinishHash(uint64_t hash)
+{
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+std::string CacheKey::GetFileName() const
+{
+  char name[33];
+  snprintf(name, sizeof(name), "%016llx%016llx", static_cast<unsigned long long>(Hash[0]),
+           static_cast<unsigned long long>(Hash[1]));
+  return name;
+}
+
+CacheKey ComputeCacheKey(const Graph& g, CachedAlgorithm algorithm, unsigned int parameter, unsigned int degreeThreshold)
+{
+  // The two halves use different seeds
+  uint64_t hashes[2] = {0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL};
+  const uint64_t header[4] = {boost::num_vertices(g), static_cast<uint64_t>(algorithm), parameter, degreeThreshold};
+  for(unsigned int i = 0; i < 4; ++i)
+    {
+    hashes[0] = HashWord(hashes[0], header[i]);
+    hashes[1] = HashWord(hashes[1], ~header[i]);
+    }
+
+  std::pair<Graph::edge_iterator, Graph::edge_iterator> edgeRange = boost::edges(g);
+  for(Graph::edge_iterator iterator = edgeRange.first; iterator != edgeRange.second; ++iterator)
+    {
+    uint64_t source = boost::source(*iterator, g);
+    uint64_t target = boost::target(*iterator, g);
+    const uint64_t word = (std::min(source, target) << 32) | std::max(source, target);
+    hashes[0] = HashWord(hashes[0], word);
+    hashes[1] = HashWord(hashes[1], ~word);
+    }
+
+  CacheKey key;
+  key.Hash[0] = FinishHash(hashes[0] ^ boost::num_edges(g));
+  key.Hash[1] = FinishHash(hashes[1] + boost::num_edges(g));
+  return key;
+}
+
+////////////////////// The cache //////////////////////
+
+// A cache file holds this magic, the number of edges as a uint64_t and then the keep-mask, 8 edges per byte.
+static const char CacheMagic[4] = {'G', 'O', 'K', 'M'};
+
+OpeningCache::OpeningCache(const std::string& directory, uint64_t maximumBytes) :
+  Directory(directory), MaximumBytes(maximumBytes), NumberOfBytes(0), Clock(0)
+{
+  mkdir(Directory.c_str(), 0755);
+
+  // Pick up the files of earlier runs, ordered by their modification time
+  std::vector<std::pair<time_t, std::string> > files;
+  if(DIR* dir = opendir(Directory.c_str()))
+    {
+    while(dirent* entry = readdir(dir))
+      {
+      std::string name = entry->d_name;
+      struct stat status;
+      if(name.size() != 32 || stat((Directory + "/" + name).c_str(), &status) != 0)
+        {
+        continue;
+        }
+      files.push_back(std::make_pair(status.st_mtime, name));
+      Entry cacheEntry = {static_cast<uint64_t>(status.st_size), 0};
+      Entries[name] = cacheEntry;
+      NumberOfBytes += status.st_size;
+      }
+    closedir(dir);
+    }
+  std::sort(files.begin(), files.end());
+  for(size_t i = 0; i < files.size(); ++i)
+    {
+    Touch(Entries.find(files[i].second));
+    }
+  Evict();
+}
+
+bool OpeningCache::Find(const CacheKey& key, std::vector<bool>& keep)
+{
+  const std::string name = key.GetFileName();
+  const std::string fileName = Directory + "/" + name;
+  uint64_t fileBytes = 0;
+  {
+  std::lock_guard<std::mutex> lock(Mutex);
+  std::map<std::string, Entry>::iterator entry = Entries.find(name);
+  if(entry == Entries.end())
+    {
+    return false;
+    }
+  Touch(entry);
+  fileBytes = entry->second.Bytes;
+  }
+
+  // A corrupt file, or a foreign one with a name like a key, must not make us allocate more than the file holds
+  const uint64_t headerBytes = sizeof(CacheMagic) + sizeof(uint64_t);
+  std::ifstream fin(fileName.c_str(), std::ios::binary);
+  char magic[4];
+  uint64_t numberOfEdges = 0;
+  fin.read(magic, sizeof(magic));
+  fin.read(reinterpret_cast<char*>(&numberOfEdges), sizeof(numberOfEdges));
+  if(!fin || memcmp(magic, CacheMagic, sizeof(magic)) != 0 || fileBytes < headerBytes ||
+     numberOfEdges > (fileBytes - headerBytes) * 8 || (numberOfEdges + 7) / 8 != fileBytes - headerBytes)
+    {
+    return false;
+    }
+  std::vector<unsigned char> bytes((numberOfEdges + 7) / 8);
+  fin.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+  if(!fin)
+    {
+    return false;
+    }
+
+  keep.resize(numberOfEdges);
+  for(uint64_t edgeId = 0; edgeId < numberOfEdges; ++edgeId)
+    {
+    keep[edgeId] = (bytes[edgeId / 8] >> (edgeId % 8)) & 1;
+    }
+
+  // Keep the order of use for the next run
+  utime(fileName.c_str(), NULL);
+  return true;
+}
+
+void OpeningCache::Store(const CacheKey& key, const std::vector<bool>& keep)
+{
+  std::vector<unsigned char> bytes((keep.size() + 7) / 8, 0);
+  for(size_t edgeId = 0; edgeId < keep.size(); ++edgeId)
+    {
+    if(keep[edgeId])
+      {
+      bytes[edgeId / 8] |= 1 << (edgeId % 8);
+      }
+    }
+
+  // Write to a temporary file first, so a reader never sees a partial file
+  const std::string name = key.GetFileName();
+  const std::string fileName = Directory + "/" + name;
+  std::stringstream temporaryFileName;
+  temporaryFileName << fileName << ".tmp" << std::this_thread::get_id();
+  {
+  std::ofstream fout(temporaryFileName.str().c_str(), std::ios::binary);
+  const uint64_t numberOfEdges = keep.size();
+  fout.write(CacheMagic, sizeof(CacheMagic));
+  fout.write(reinterpret_cast<const char*>(&numberOfEdges), sizeof(numberOfEdges));
+  fout.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  if(!fout)
+    {
+    remove(temporaryFileName.str().c_str());
+    return;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(Mutex);
+  if(rename(temporaryFileName.str().c_str(), fileName.c_str()) != 0)
+    {
+    remove(temporaryFileName.str().c_str());
+    return;
+    }
+  const uint64_t fileBytes = sizeof(CacheMagic) + sizeof(uint64_t) + bytes.size();
+  std::map<std::string, Entry>::iterator entry = Entries.find(name);
+  if(entry == Entries.end())
+    {
+    Entry cacheEntry = {0, 0};
+    entry = Entries.insert(std::make_pair(name, cacheEntry)).first;
+    }
+  NumberOfBytes -= entry->second.Bytes;
+  entry->second.Bytes = fileBytes;
+  NumberOfBytes += fileBytes;
+  Touch(entry);
+  Evict();
+}
+
+void OpeningCache::Touch(const std::map<std::string, Entry>::iterator entry)
+{
+  // LastUsed is 0 for an entry which was never used
+  Recency.erase(entry->second.LastUsed);
+  entry->second.LastUsed = ++Clock;
+  Recency[entry->second.LastUsed] = entry->first;
+}
+
+void OpeningCache::Evict()
+{
+  while(NumberOfBytes > MaximumBytes && !Recency.empty())
+    {
+    std::map<uint64_t, std::string>::iterator oldest = Recency.begin();
+    std::map<std::string, Entry>::iterator entry = Entries.find(oldest->second);
+    remove((Directory + "/" + entry->first).c_str());
+    NumberOfBytes -= entry->second.Bytes;
+    Entries.erase(entry);
+    Recency.erase(oldest);
+    }
+}
+
+////////////////////// Cached openings //////////////////////
+
+template <typename TOpen>
+static Graph OpenGraphCached(const Graph& g, const CacheKey& key, OpeningCache& cache, OpeningStatistics* statistics,
+                             TOpen open)
+{
+  Timer timer;
+  std::vector<bool> keep;
+  if(cache.Find(key, keep) && keep.size() == boost::num_edges(g))
+    {
+    if(statistics)
+      {
+      statistics->FromCache = true;
+      statistics->CacheSeconds = timer.GetElapsedSeconds();
+      }
+    return CreateGraphFromKeepMask(g, keep);
+    }
+  double cacheSeconds = timer.GetElapsedSeconds();
+
+  timer.Restart();
+  CompactGraph compactGraph = CreateCompactGraph(g);
+  if(statistics)
+    {
+    statistics->BuildSeconds = timer.GetElapsedSeconds();
+    }
+  keep = open(compactGraph);
+
+  timer.Restart();
+  cache.Store(key, keep);
+  if(statistics)
+    {
+    statistics->FromCache = false;
+    statistics->CacheSeconds = cacheSeconds + timer.GetElapsedSeconds();
+    }
+  return CreateGraphFromKeepMask(g, keep);
+}
+
+Graph OpenGraphFixedCached(const Graph& g, unsigned int numberOfIterations, OpeningCache& cache,
+                           OpeningStatistics* statistics)
+{
+  CacheKey key = ComputeCacheKey(g, CachedFixedIterations, numberOfIterations);
+  return OpenGraphCached(g, key, cache, statistics, [&](const CompactGraph& compactGraph)
+    {
+    return OpenCompactGraphFixed(compactGraph, numberOfIterations, 1, statistics);
+    });
+}
+
+Graph OpenGraphNullRemovalDifferenceCached(const Graph& g, unsigned int goalSuccessiveNullDifferences, OpeningCache& cache,
+                                           OpeningStatistics* statistics)
+{
+  CacheKey key = ComputeCacheKey(g, CachedNullRemovalDifference, goalSuccessiveNullDifferences);
+  return OpenGraphCached(g, key, cache, statistics, [&](const CompactGraph& compactGraph)
+    {
+    return OpenCompactGraphNullRemovalDifference(compactGraph, goalSuccessiveNullDifferences, 1, statistics);
+    });
+}
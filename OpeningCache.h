@@ -0,0 +1,108 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef OPENINGCACHE_H
+#define OPENINGCACHE_H
+
+// STL
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "OpeningStatistics.h"
+#include "Types.h"
+
+// The stopping rule of a cached opening
+enum CachedAlgorithm
+{
+  CachedFixedIterations,
+  CachedNullRemovalDifference
+};
+
+// Identifies an opening by a 128 bit hash of the edge list of the graph (in boost::edges() order, with the
+// end points of each edge sorted), its number of vertices, the algorithm and its parameters.
+struct CacheKey
+{
+  uint64_t Hash[2];
+
+  // 32 hexadecimal digits
+  std::string GetFileName() const;
+};
+
+CacheKey ComputeCacheKey(const Graph& g, CachedAlgorithm algorithm, unsigned int parameter, unsigned int degreeThreshold = 1);
+
+// Keep-masks of earlier openings, stored one file per opening in a local directory. When the files take
+// more than 'maximumBytes', the least recently used ones are deleted. The cache may be shared by
+// several threads; it is not safe to share a directory between processes running at the same time.
+class OpeningCache
+{
+public:
+  // The directory is created if it does not exist.
+  OpeningCache(const std::string& directory, uint64_t maximumBytes);
+
+  // If the opening is in the cache, set 'keep' to its keep-mask and return true.
+  bool Find(const CacheKey& key, std::vector<bool>& keep);
+
+  // Add the keep-mask of an opening, evicting the least recently used ones if needed.
+  void Store(const CacheKey& key, const std::vector<bool>& keep);
+
+  uint64_t GetNumberOfBytes() const
+  {
+    return NumberOfBytes;
+  }
+
+private:
+  struct Entry
+  {
+    uint64_t Bytes;
+    // Larger is more recent
+    uint64_t LastUsed;
+  };
+
+  // Mark an entry as the most recently used one
+  void Touch(std::map<std::string, Entry>::iterator entry);
+
+  void Evict();
+
+  std::string Directory;
+  uint64_t MaximumBytes;
+  uint64_t NumberOfBytes;
+  uint64_t Clock;
+  std::map<std::string, Entry> Entries;
+
+  // The name of every entry by its LastUsed, so the least recently used one is found without a scan
+  std::map<uint64_t, std::string> Recency;
+  std::mutex Mutex;
+};
+
+// These are equivalent to OpenGraphFixedTracking and OpenGraphNullRemovalDifferenceTracking, but return
+// the result from 'cache' if the same graph was opened with the same parameters before. Otherwise the
+// graph is opened by OpeningEngine (see GraphOpeningPeeling.h) and the result is added to the cache.
+// 'statistics' tells whether the result came from the cache (FromCache) and the time spent in the cache.
+Graph OpenGraphFixedCached(const Graph& g, unsigned int numberOfIterations, OpeningCache& cache,
+                           OpeningStatistics* statistics = NULL);
+
+Graph OpenGraphNullRemovalDifferenceCached(const Graph& g, unsigned int goalSuccessiveNullDifferences, OpeningCache& cache,
+                                           OpeningStatistics* statistics = NULL);
+
+#endif
@@ -0,0 +1,27 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "OpeningEngine.h"
+
+template class OpeningEngine<CompactGraph, FixedIterations>;
+template class OpeningEngine<CompactGraph, FixedIterations, StatisticsObserver>;
+template class OpeningEngine<CompactGraph, FixedIterations, NullObserver, uint32_t, BitmapFrontier>;
+template class OpeningEngine<CompactGraph, NullRemovalDifference>;
+template class OpeningEngine<CompactGraph, NullRemovalDifference, StatisticsObserver>;
+template class OpeningEngine<CompactGraph64, FixedIterations>;
+template class OpeningEngine<CompactGraph64, NullRemovalDifference>;
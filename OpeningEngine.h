@@ -0,0 +1,652 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef OPENINGENGINE_H
+#define OPENINGENGINE_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "CompactGraph.h"
+#include "OpeningStatistics.h"
+
+/*
+The opening engine performs the tracking erosion and dilation (see GraphOpeningTracking.h) on a read-only
+adjacency, marking edges as removed instead of modifying a graph. Everything which callers may want to
+customize is a template parameter, so the inner loops are compiled separately for every combination
+and a feature which is not used costs nothing:
+
+TAdjacency        The graph backend. It must provide NumberOfVertices, NumberOfEdges, Degree(v) and
+                  ForEachNeighbor(v, visitor), see CompactAdjacency.
+TStoppingPolicy   Decides how many erosions to perform (FixedIterations, NullRemovalDifference).
+TObserver         Is told about every round (NullObserver, StatisticsObserver), and can cancel the opening
+                  between rounds.
+TIndex            The integer type of the per-vertex and per-edge workspace (uint32_t or uint64_t).
+TFrontier         Collects the end points of the next erosion (QueueFrontier, BitmapFrontier).
+
+An end point is a vertex with between 1 and 'degreeThreshold' neighbors, so with the default threshold
+of 1 the results are identical to OpenGraphFixedTracking and OpenGraphNullRemovalDifferenceTracking.
+*/
+
+////////////////////// Stopping policies //////////////////////
+
+// Perform a fixed number of erosions.
+class FixedIterations
+{
+public:
+  // This policy does not look at the number of removals, so the engine does not count them.
+  static const bool CountsRemovals = false;
+
+  explicit FixedIterations(const unsigned int numberOfIterations) : NumberOfIterations(numberOfIterations) {}
+
+  // Decide whether to erode again, given the number of erosions so far and the number of removals in the last one.
+  bool Continue(const unsigned int numberOfErosions, const size_t)
+  {
+    return numberOfErosions < NumberOfIterations;
+  }
+
+  // Called when Continue() returned true but the next erosion, and every one after it, will remove nothing.
+  // Returns the total number of erosions which would be performed.
+  unsigned int Finish(const unsigned int)
+  {
+    return NumberOfIterations;
+  }
+
+private:
+  unsigned int NumberOfIterations;
+};
+
+// Erode until the number of removals has been the same in 'goalSuccessiveNullDifferences' successive erosions.
+// The removals are counted as in ErodeTracking, which processes a potential end point once for every time
+// it was added to its list.
+class NullRemovalDifference
+{
+public:
+  static const bool CountsRemovals = true;
+
+  explicit NullRemovalDifference(const unsigned int goalSuccessiveNullDifferences) :
+    GoalSuccessiveNullDifferences(goalSuccessiveNullDifferences), NumberOfSuccessiveNullDifferences(0),
+    NumberOfPreviousRemovals(0) {}
+
+  bool Continue(const unsigned int numberOfErosions, const size_t numberOfRemovals)
+  {
+    if(numberOfErosions > 0)
+      {
+      if(numberOfRemovals == NumberOfPreviousRemovals)
+        {
+        NumberOfSuccessiveNullDifferences++;
+        }
+      else
+        {
+        NumberOfSuccessiveNullDifferences = 0;
+        }
+      NumberOfPreviousRemovals = numberOfRemovals;
+      }
+    return NumberOfSuccessiveNullDifferences < GoalSuccessiveNullDifferences;
+  }
+
+  unsigned int Finish(unsigned int numberOfErosions)
+  {
+    do
+      {
+      numberOfErosions++;
+      } while(Continue(numberOfErosions, 0));
+    return numberOfErosions;
+  }
+
+private:
+  unsigned int GoalSuccessiveNullDifferences;
+  unsigned int NumberOfSuccessiveNullDifferences;
+  size_t NumberOfPreviousRemovals;
+};
+
+// Erode until nothing more can be removed, or at most 'maximumNumberOfErosions' times (0 means no limit).
+// This is used to compute the complete peeling order rather than to open a graph.
+class ExhaustivePeeling
+{
+public:
+  static const bool CountsRemovals = true;
+
+  explicit ExhaustivePeeling(const unsigned int maximumNumberOfErosions) :
+    MaximumNumberOfErosions(maximumNumberOfErosions > 0 ? maximumNumberOfErosions : std::numeric_limits<unsigned int>::max()) {}
+
+  bool Continue(const unsigned int numberOfErosions, const size_t)
+  {
+    return numberOfErosions < MaximumNumberOfErosions;
+  }
+
+  // Empty erosions are not counted
+  unsigned int Finish(const unsigned int numberOfErosions)
+  {
+    return numberOfErosions;
+  }
+
+private:
+  unsigned int MaximumNumberOfErosions;
+};
+
+////////////////////// Observers //////////////////////
+
+// Does nothing. All of the calls are inlined away.
+struct NullObserver
+{
+  // Called before finding the end points and before every round.
+  void Start() {}
+
+  void FoundEndPoints(const size_t) {}
+
+  // 'frontier' holds the end points which were eroded, 'numberOfRemovals' is only counted if the stopping policy needs it.
+  template <typename TIndex>
+  void Eroded(const unsigned int, const std::vector<TIndex>&, const size_t, const size_t) {}
+
+  template <typename TIndex>
+  void Dilated(const unsigned int, const std::vector<TIndex>&, const size_t) {}
+
+  void Finished(const size_t) {}
+
+  // Asked before every round. Returning true stops the opening, see OpeningEngine::WasCancelled().
+  bool Cancelled() const
+  {
+    return false;
+  }
+};
+
+// Fills in an OpeningStatistics.
+class StatisticsObserver
+{
+public:
+  explicit StatisticsObserver(OpeningStatistics* statistics) : Statistics(statistics) {}
+
+  void Start()
+  {
+    RoundTimer.Restart();
+  }
+
+  void FoundEndPoints(const size_t)
+  {
+    Statistics->FindEndPointsSeconds = RoundTimer.GetElapsedSeconds();
+  }
+
+  template <typename TIndex>
+  void Eroded(const unsigned int, const std::vector<TIndex>& frontier, const size_t, const size_t numberOfEdgesRemoved)
+  {
+    Statistics->AddErosion(RoundTimer.GetElapsedSeconds(), frontier.size(), numberOfEdgesRemoved);
+  }
+
+  template <typename TIndex>
+  void Dilated(const unsigned int, const std::vector<TIndex>& endPoints, const size_t numberOfEdgesRestored)
+  {
+    Statistics->AddDilation(RoundTimer.GetElapsedSeconds(), endPoints.size(), numberOfEdgesRestored);
+  }
+
+  void Finished(const size_t workspaceBytes)
+  {
+    Statistics->UpdatePeakWorkspaceBytes(workspaceBytes);
+  }
+
+  bool Cancelled() const
+  {
+    return false;
+  }
+
+private:
+  OpeningStatistics* Statistics;
+  Timer RoundTimer;
+};
+
+////////////////////// Frontiers //////////////////////
+
+// Keeps the end points of the next erosion in the order they were found. This is the cheapest
+// frontier when only a small part of the graph changes in each round, which is the usual case.
+template <typename TIndex>
+class QueueFrontier
+{
+public:
+  void Initialize(const TIndex)
+  {
+    Next.clear();
+  }
+
+  void Push(const TIndex v)
+  {
+    Next.push_back(v);
+  }
+
+  // Move the vertices pushed since the last call into 'current', replacing its contents.
+  void Advance(std::vector<TIndex>& current)
+  {
+    current.swap(Next);
+    Next.clear();
+  }
+
+  size_t GetAllocatedBytes() const
+  {
+    return Next.capacity() * sizeof(TIndex);
+  }
+
+private:
+  std::vector<TIndex> Next;
+};
+
+// Marks the end points of the next erosion in a bitmap and hands them out in increasing vertex order.
+// Visiting the vertices in memory order helps when the frontiers are a large part of the graph.
+template <typename TIndex>
+class BitmapFrontier
+{
+public:
+  void Initialize(const TIndex numberOfVertices)
+  {
+    Words.assign(numberOfVertices / 64 + 1, 0);
+    FirstWord = Words.size();
+    LastWord = 0;
+  }
+
+  void Push(const TIndex v)
+  {
+    size_t word = v / 64;
+    Words[word] |= uint64_t(1) << (v % 64);
+    FirstWord = std::min(FirstWord, word);
+    LastWord = std::max(LastWord, word);
+  }
+
+  void Advance(std::vector<TIndex>& current)
+  {
+    current.clear();
+    for(size_t word = FirstWord; word <= LastWord && word < Words.size(); ++word)
+      {
+      uint64_t bits = Words[word];
+      while(bits != 0)
+        {
+        unsigned int bit = __builtin_ctzll(bits);
+        current.push_back(static_cast<TIndex>(word * 64 + bit));
+        bits &= bits - 1;
+        }
+      Words[word] = 0;
+      }
+    FirstWord = Words.size();
+    LastWord = 0;
+  }
+
+  size_t GetAllocatedBytes() const
+  {
+    return Words.capacity() * sizeof(uint64_t);
+  }
+
+private:
+  std::vector<uint64_t> Words;
+  size_t FirstWord;
+  size_t LastWord;
+};
+
+////////////////////// The engine //////////////////////
+
+template <typename TAdjacency, typename TStoppingPolicy, typename TObserver = NullObserver,
+          typename TIndex = typename TAdjacency::IndexType, template <typename> class TFrontier = QueueFrontier>
+class OpeningEngine
+{
+public:
+  OpeningEngine() : DegreeThreshold(1), NumberOfErosions(0), Cancelled(false) {}
+
+  void SetDegreeThreshold(const unsigned int degreeThreshold)
+  {
+    DegreeThreshold = degreeThreshold;
+  }
+
+  // Erode 'g' as long as 'stopping' says so, then dilate it as many times. 'keep' is set to a keep-mask over the
+  // edges of 'g'. The workspace is kept between calls, so reusing an engine avoids reallocating it.
+  void Open(const TAdjacency& g, TStoppingPolicy stopping, TObserver& observer, std::vector<bool>& keep);
+
+  // Only perform the erosions. Returns the number of erosions.
+  unsigned int Erode(const TAdjacency& g, TStoppingPolicy& stopping, TObserver& observer);
+
+  // Dilate the result of the last Erode() as many times as it eroded, and set 'keep' to the result.
+  void Dilate(const TAdjacency& g, TObserver& observer, std::vector<bool>& keep);
+
+  // The erosion (starting at 1) in which every edge/vertex was removed by the last Erode(), or 0.
+  const std::vector<TIndex>& GetEdgeRounds() const
+  {
+    return EdgeRounds;
+  }
+
+  const std::vector<TIndex>& GetVertexRounds() const
+  {
+    return VertexRounds;
+  }
+
+  unsigned int GetNumberOfErosions() const
+  {
+    return NumberOfErosions;
+  }
+
+  // Whether the observer cancelled the last opening. The keep-mask and rounds are then incomplete.
+  bool WasCancelled() const
+  {
+    return Cancelled;
+  }
+
+  size_t GetAllocatedBytes() const;
+
+private:
+  bool IsEndPoint(const TIndex degree) const
+  {
+    return degree >= 1 && degree <= DegreeThreshold;
+  }
+
+  unsigned int DegreeThreshold;
+  unsigned int NumberOfErosions;
+  bool Cancelled;
+
+  // The working degree of every vertex. Edges are never physically removed, they are only marked in
+  // EdgeRounds, so removing an edge is O(1) regardless of the degree of its end points.
+  std::vector<TIndex> Degrees;
+  std::vector<TIndex> EdgeRounds;
+  std::vector<TIndex> VertexRounds;
+
+  // How many times ErodeTracking would have each vertex in its list of potential end points,
+  // only used if the stopping policy counts removals.
+  std::vector<TIndex> Pushes;
+  std::vector<TIndex> PushedVertices;
+
+  TFrontier<TIndex> Frontier;
+  std::vector<TIndex> Current;
+
+  // The vertices which lost an edge in the last erosion, where the dilation starts.
+  std::vector<TIndex> Touched;
+
+  std::vector<TIndex> Visited;
+  std::vector<TIndex> EndPoints;
+  std::vector<TIndex> NextPotentialEndPoints;
+};
+
+template <typename TAdjacency, typename TStoppingPolicy, typename TObserver, typename TIndex, template <typename> class TFrontier>
+void OpeningEngine<TAdjacency, TStoppingPolicy, TObserver, TIndex, TFrontier>::Open(
+  const TAdjacency& g, TStoppingPolicy stopping, TObserver& observer, std::vector<bool>& keep)
+{
+  Erode(g, stopping, observer);
+  if(!Cancelled)
+    {
+    Dilate(g, observer, keep);
+    }
+  observer.Finished(GetAllocatedBytes());
+}
+
+template <typename TAdjacency, typename TStoppingPolicy, typename TObserver, typename TIndex, template <typename> class TFrontier>
+unsigned int OpeningEngine<TAdjacency, TStoppingPolicy, TObserver, TIndex, TFrontier>::Erode(
+  const TAdjacency& g, TStoppingPolicy& stopping, TObserver& observer)
+{
+  const bool countsRemovals = TStoppingPolicy::CountsRemovals;
+  const TIndex numberOfVertices = g.NumberOfVertices;
+
+  Cancelled = false;
+  observer.Start();
+  Degrees.resize(numberOfVertices);
+  EdgeRounds.assign(g.NumberOfEdges, 0);
+  VertexRounds.assign(numberOfVertices, 0);
+  if(countsRemovals)
+    {
+    Pushes.assign(numberOfVertices, 0);
+    PushedVertices.clear();
+    }
+  Touched.clear();
+  Frontier.Initialize(numberOfVertices);
+
+  for(TIndex v = 0; v < numberOfVertices; ++v)
+    {
+    Degrees[v] = g.Degree(v);
+    if(IsEndPoint(Degrees[v]))
+      {
+      VertexRounds[v] = 1;
+      Frontier.Push(v);
+      if(countsRemovals)
+        {
+        Pushes[v] = 1;
+        }
+      }
+    }
+  Frontier.Advance(Current);
+  observer.FoundEndPoints(Current.size());
+
+  TIndex round = 0;
+  size_t numberOfRemovals = 0;
+  while(stopping.Continue(round, numberOfRemovals))
+    {
+    if(observer.Cancelled())
+      {
+      Cancelled = true;
+      break;
+      }
+    if(Current.empty())
+      {
+      // Nothing will ever be removed again
+      round = stopping.Finish(round);
+      Touched.clear();
+      break;
+      }
+
+    observer.Start();
+    round++;
+    numberOfRemovals = 0;
+    size_t numberOfEdgesRemoved = 0;
+    Touched.clear();
+
+    // Remove every remaining edge of the end points. Neighbors which drop to the threshold are queued
+    // for the next round, so the end points of a round are decided by the degrees at its start.
+    for(size_t i = 0; i < Current.size(); ++i)
+      {
+      const TIndex v = Current[i];
+      g.ForEachNeighbor(v, [&](const TIndex neighbor, const TIndex edgeId)
+        {
+        const TIndex edgeRound = EdgeRounds[edgeId];
+        if(edgeRound != 0 && edgeRound != round)
+          {
+          return;
+          }
+
+        // The edge existed at the start of the round, so ErodeTracking would push the neighbor
+        if(countsRemovals)
+          {
+          numberOfRemovals += Pushes[v];
+          if(VertexRounds[neighbor] == 0 || VertexRounds[neighbor] == round + 1)
+            {
+            if(Pushes[neighbor] == 0)
+              {
+              PushedVertices.push_back(neighbor);
+              }
+            Pushes[neighbor] += Pushes[v];
+            }
+          }
+
+        if(edgeRound != 0)
+          {
+          return;
+          }
+        EdgeRounds[edgeId] = round;
+        numberOfEdgesRemoved++;
+        Degrees[v]--;
+        Degrees[neighbor]--;
+        Touched.push_back(neighbor);
+
+        if(VertexRounds[neighbor] == 0 && IsEndPoint(Degrees[neighbor]))
+          {
+          VertexRounds[neighbor] = round + 1;
+          Frontier.Push(neighbor);
+          }
+        });
+      }
+    observer.Eroded(round, Current, numberOfRemovals, numberOfEdgesRemoved);
+
+    // A queued vertex may have lost all of its edges later in the same round. It is then isolated
+    // rather than an end point, so it is dropped from the next round.
+    Frontier.Advance(Current);
+    size_t numberOfEndPoints = 0;
+    for(size_t i = 0; i < Current.size(); ++i)
+      {
+      const TIndex v = Current[i];
+      if(Degrees[v] == 0)
+        {
+        VertexRounds[v] = 0;
+        continue;
+        }
+      Current[numberOfEndPoints] = v;
+      numberOfEndPoints++;
+      }
+    Current.resize(numberOfEndPoints);
+
+    // Pushes to vertices which are not end points at the start of the next round are discarded
+    if(countsRemovals)
+      {
+      for(size_t i = 0; i < PushedVertices.size(); ++i)
+        {
+        if(VertexRounds[PushedVertices[i]] != round + 1)
+          {
+          Pushes[PushedVertices[i]] = 0;
+          }
+        }
+      PushedVertices.clear();
+      }
+    }
+
+  // Forget the end points queued for an erosion which was not performed
+  for(size_t i = 0; i < Current.size(); ++i)
+    {
+    VertexRounds[Current[i]] = 0;
+    }
+  Current.clear();
+
+  NumberOfErosions = round;
+  return NumberOfErosions;
+}
+
+template <typename TAdjacency, typename TStoppingPolicy, typename TObserver, typename TIndex, template <typename> class TFrontier>
+void OpeningEngine<TAdjacency, TStoppingPolicy, TObserver, TIndex, TFrontier>::Dilate(
+  const TAdjacency& g, TObserver& observer, std::vector<bool>& keep)
+{
+  // Start from the eroded graph
+  keep.resize(g.NumberOfEdges);
+  for(TIndex edgeId = 0; edgeId < g.NumberOfEdges; ++edgeId)
+    {
+    keep[edgeId] = (EdgeRounds[edgeId] == 0);
+    }
+
+  // 'Visited' holds the last dilation in which a vertex was considered, to skip duplicates
+  Visited.assign(g.NumberOfVertices, 0);
+  std::vector<TIndex>& potentialEndPoints = Touched;
+  for(TIndex dilation = 1; dilation <= NumberOfErosions; ++dilation)
+    {
+    if(potentialEndPoints.empty())
+      {
+      // Nothing will ever be added again
+      break;
+      }
+    if(observer.Cancelled())
+      {
+      Cancelled = true;
+      break;
+      }
+    observer.Start();
+
+    // Decide which vertices are end points before adding any edges in this round
+    EndPoints.clear();
+    for(size_t i = 0; i < potentialEndPoints.size(); ++i)
+      {
+      const TIndex v = potentialEndPoints[i];
+      if(Visited[v] == dilation)
+        {
+        continue;
+        }
+      Visited[v] = dilation;
+      if(IsEndPoint(Degrees[v]))
+        {
+        EndPoints.push_back(v);
+        }
+      }
+
+    // Add back all of the edges the end points had in the original graph
+    NextPotentialEndPoints.clear();
+    size_t numberOfEdgesRestored = 0;
+    for(size_t i = 0; i < EndPoints.size(); ++i)
+      {
+      const TIndex v = EndPoints[i];
+      g.ForEachNeighbor(v, [&](const TIndex neighbor, const TIndex edgeId)
+        {
+        if(keep[edgeId])
+          {
+          return;
+          }
+        keep[edgeId] = true;
+        numberOfEdgesRestored++;
+        Degrees[v]++;
+        Degrees[neighbor]++;
+        NextPotentialEndPoints.push_back(neighbor);
+        });
+      }
+    potentialEndPoints.swap(NextPotentialEndPoints);
+    observer.Dilated(dilation, EndPoints, numberOfEdgesRestored);
+    }
+}
+
+template <typename TAdjacency, typename TStoppingPolicy, typename TObserver, typename TIndex, template <typename> class TFrontier>
+size_t OpeningEngine<TAdjacency, TStoppingPolicy, TObserver, TIndex, TFrontier>::GetAllocatedBytes() const
+{
+  return (Degrees.capacity() + EdgeRounds.capacity() + VertexRounds.capacity() + Pushes.capacity() +
+          PushedVertices.capacity() + Current.capacity() + Touched.capacity() + Visited.capacity() +
+          EndPoints.capacity() + NextPotentialEndPoints.capacity()) * sizeof(TIndex) +
+         Frontier.GetAllocatedBytes();
+}
+
+// Open 'g' with an engine for the given policies and return the keep-mask.
+template <typename TAdjacency, typename TStoppingPolicy>
+std::vector<bool> OpenWithEngine(const TAdjacency& g, const TStoppingPolicy& stopping, const unsigned int degreeThreshold,
+                                 OpeningStatistics* statistics)
+{
+  std::vector<bool> keep;
+  if(statistics)
+    {
+    OpeningEngine<TAdjacency, TStoppingPolicy, StatisticsObserver> engine;
+    engine.SetDegreeThreshold(degreeThreshold);
+    StatisticsObserver observer(statistics);
+    engine.Open(g, stopping, observer, keep);
+    statistics->UpdatePeakWorkspaceBytes(engine.GetAllocatedBytes() + GetAllocatedBytes(g));
+    }
+  else
+    {
+    OpeningEngine<TAdjacency, TStoppingPolicy> engine;
+    engine.SetDegreeThreshold(degreeThreshold);
+    NullObserver observer;
+    engine.Open(g, stopping, observer, keep);
+    }
+  return keep;
+}
+
+// The common combinations are compiled into the library.
+extern template class OpeningEngine<CompactGraph, FixedIterations>;
+extern template class OpeningEngine<CompactGraph, FixedIterations, StatisticsObserver>;
+extern template class OpeningEngine<CompactGraph, FixedIterations, NullObserver, uint32_t, BitmapFrontier>;
+extern template class OpeningEngine<CompactGraph, NullRemovalDifference>;
+extern template class OpeningEngine<CompactGraph, NullRemovalDifference, StatisticsObserver>;
+extern template class OpeningEngine<CompactGraph64, FixedIterations>;
+extern template class OpeningEngine<CompactGraph64, NullRemovalDifference>;
+
+#endif
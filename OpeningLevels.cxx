@@ -0,0 +1,281 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "OpeningLevels.h"
+
+// STL
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// C
+#include <stdint.h>
+
+// Boost
+#include <boost/graph/graphviz.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/property_map/function_property_map.hpp>
+
+// Custom
+#include "Helpers.h"
+#include "OpeningEngine.h"
+
+std::vector<bool> OpeningLevels::GetKeepMaskAfterErosion(const unsigned int numberOfErosions) const
+{
+  std::vector<bool> keep(ErosionRounds.size());
+  for(size_t edgeId = 0; edgeId < ErosionRounds.size(); ++edgeId)
+    {
+    keep[edgeId] = ExistsAfterErosion(edgeId, numberOfErosions);
+    }
+  return keep;
+}
+
+std::vector<bool> OpeningLevels::GetKeepMaskAfterDilation(const unsigned int numberOfDilations) const
+{
+  std::vector<bool> keep(ErosionRounds.size());
+  for(size_t edgeId = 0; edgeId < ErosionRounds.size(); ++edgeId)
+    {
+    keep[edgeId] = ExistsAfterDilation(edgeId, numberOfDilations);
+    }
+  return keep;
+}
+
+// Records the end points of every dilation. The edges they added back are found afterwards.
+class DilationRecordingObserver : public NullObserver
+{
+public:
+  DilationRecordingObserver()
+  {
+    Offsets.push_back(0);
+  }
+
+  void Dilated(const unsigned int, const std::vector<unsigned int>& endPoints, const size_t)
+  {
+    EndPoints.insert(EndPoints.end(), endPoints.begin(), endPoints.end());
+    Offsets.push_back(EndPoints.size());
+  }
+
+  // The end points of dilation r are [Offsets[r-1], Offsets[r]) of EndPoints.
+  std::vector<unsigned int> EndPoints;
+  std::vector<size_t> Offsets;
+};
+
+template <typename TStoppingPolicy>
+static OpeningLevels ComputeOpeningLevels(const CompactGraph& g, TStoppingPolicy stopping, const unsigned int degreeThreshold)
+{
+  OpeningEngine<CompactGraph, TStoppingPolicy, DilationRecordingObserver> engine;
+  engine.SetDegreeThreshold(degreeThreshold);
+  DilationRecordingObserver observer;
+  std::vector<bool> keep;
+  engine.Open(g, stopping, observer, keep);
+
+  OpeningLevels levels;
+  levels.NumberOfErosions = engine.GetNumberOfErosions();
+  levels.ErosionRounds = engine.GetEdgeRounds();
+  levels.DilationRounds.assign(g.NumberOfEdges, 0);
+
+  // A dilation adds back every removed edge of its end points which an earlier dilation has not
+  for(unsigned int dilation = 1; dilation < observer.Offsets.size(); ++dilation)
+    {
+    for(size_t i = observer.Offsets[dilation - 1]; i < observer.Offsets[dilation]; ++i)
+      {
+      g.ForEachNeighbor(observer.EndPoints[i], [&](const unsigned int, const unsigned int edgeId)
+        {
+        if(levels.ErosionRounds[edgeId] != 0 && levels.DilationRounds[edgeId] == 0)
+          {
+          levels.DilationRounds[edgeId] = dilation;
+          }
+        });
+      }
+    }
+  return levels;
+}
+
+OpeningLevels ComputeOpeningLevelsFixed(const CompactGraph& g, unsigned int numberOfIterations, unsigned int degreeThreshold)
+{
+  return ComputeOpeningLevels(g, FixedIterations(numberOfIterations), degreeThreshold);
+}
+
+OpeningLevels ComputeOpeningLevelsNullRemovalDifference(const CompactGraph& g, unsigned int goalSuccessiveNullDifferences,
+                                                        unsigned int degreeThreshold)
+{
+  return ComputeOpeningLevels(g, NullRemovalDifference(goalSuccessiveNullDifferences), degreeThreshold);
+}
+
+// The graphviz attributes of an edge
+struct EdgeLevelAttribute
+{
+  typedef std::string result_type;
+
+  enum Attribute {Erosion, Dilation, Style};
+
+  EdgeLevelAttribute(const EdgePositionMap* positions, const OpeningLevels* levels, const Attribute attribute) :
+    Positions(positions), Levels(levels), Which(attribute) {}
+
+  std::string operator()(const Graph::edge_descriptor& e) const
+  {
+    const size_t edgeId = (*Positions)[e];
+    switch(Which)
+      {
+      case Erosion:
+        return boost::lexical_cast<std::string>(Levels->ErosionRounds[edgeId]);
+      case Dilation:
+        return boost::lexical_cast<std::string>(Levels->DilationRounds[edgeId]);
+      default:
+        return Levels->ExistsAfterDilation(edgeId, Levels->NumberOfErosions) ? "normal" : "invis";
+      }
+  }
+
+  const EdgePositionMap* Positions;
+  const OpeningLevels* Levels;
+  Attribute Which;
+};
+
+void WriteOpeningLevelsDOT(const Graph& g, const OpeningLevels& levels, const std::string& fileName)
+{
+  if(levels.ErosionRounds.size() != boost::num_edges(g))
+    {
+    throw std::invalid_argument("the levels must have one entry for every edge of the graph");
+    }
+
+  EdgePositionMap positions(g);
+  boost::dynamic_properties dp;
+  dp.property("erosion", boost::make_function_property_map<Graph::edge_descriptor>(
+                           EdgeLevelAttribute(&positions, &levels, EdgeLevelAttribute::Erosion)));
+  dp.property("dilation", boost::make_function_property_map<Graph::edge_descriptor>(
+                            EdgeLevelAttribute(&positions, &levels, EdgeLevelAttribute::Dilation)));
+  dp.property("style", boost::make_function_property_map<Graph::edge_descriptor>(
+                         EdgeLevelAttribute(&positions, &levels, EdgeLevelAttribute::Style)));
+  dp.property("node_id", get(boost::vertex_index, g));
+
+  std::ofstream fout(fileName.c_str());
+  boost::write_graphviz_dp(fout, g, dp);
+}
+
+static const char LevelsMagic[4] = {'G', 'O', 'L', 'V'};
+static const uint32_t LevelsVersion = 1;
+
+// The number of bytes needed to store every round up to 'numberOfErosions'
+static uint32_t GetBytesPerRound(const unsigned int numberOfErosions)
+{
+  if(numberOfErosions <= 0xff)
+    {
+    return 1;
+    }
+  if(numberOfErosions <= 0xffff)
+    {
+    return 2;
+    }
+  return 4;
+}
+
+template <typename T>
+static void WriteRounds(const std::vector<unsigned int>& rounds, std::ofstream& fout)
+{
+  std::vector<T> narrowRounds(rounds.begin(), rounds.end());
+  fout.write(reinterpret_cast<const char*>(narrowRounds.data()), narrowRounds.size() * sizeof(T));
+}
+
+template <typename T>
+static void ReadRounds(const size_t numberOfEdges, std::ifstream& fin, std::vector<unsigned int>& rounds)
+{
+  std::vector<T> narrowRounds(numberOfEdges);
+  fin.read(reinterpret_cast<char*>(narrowRounds.data()), narrowRounds.size() * sizeof(T));
+  rounds.assign(narrowRounds.begin(), narrowRounds.end());
+}
+
+bool WriteOpeningLevelsBinary(const OpeningLevels& levels, const std::string& fileName)
+{
+  std::ofstream fout(fileName.c_str(), std::ios::binary);
+  const uint64_t numberOfEdges = levels.ErosionRounds.size();
+  const uint32_t numberOfErosions = levels.NumberOfErosions;
+  const uint32_t bytesPerRound = GetBytesPerRound(levels.NumberOfErosions);
+  fout.write(LevelsMagic, sizeof(LevelsMagic));
+  fout.write(reinterpret_cast<const char*>(&LevelsVersion), sizeof(LevelsVersion));
+  fout.write(reinterpret_cast<const char*>(&numberOfEdges), sizeof(numberOfEdges));
+  fout.write(reinterpret_cast<const char*>(&numberOfErosions), sizeof(numberOfErosions));
+  fout.write(reinterpret_cast<const char*>(&bytesPerRound), sizeof(bytesPerRound));
+
+  const std::vector<unsigned int>* rounds[2] = {&levels.ErosionRounds, &levels.DilationRounds};
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+    if(bytesPerRound == 1)
+      {
+      WriteRounds<uint8_t>(*rounds[i], fout);
+      }
+    else if(bytesPerRound == 2)
+      {
+      WriteRounds<uint16_t>(*rounds[i], fout);
+      }
+    else
+      {
+      WriteRounds<uint32_t>(*rounds[i], fout);
+      }
+    }
+  return fout.good();
+}
+
+bool ReadOpeningLevelsBinary(const std::string& fileName, OpeningLevels& levels)
+{
+  std::ifstream fin(fileName.c_str(), std::ios::binary);
+  char magic[4];
+  uint32_t version = 0;
+  uint64_t numberOfEdges = 0;
+  uint32_t numberOfErosions = 0;
+  uint32_t bytesPerRound = 0;
+  fin.read(magic, sizeof(magic));
+  fin.read(reinterpret_cast<char*>(&version), sizeof(version));
+  fin.read(reinterpret_cast<char*>(&numberOfEdges), sizeof(numberOfEdges));
+  fin.read(reinterpret_cast<char*>(&numberOfErosions), sizeof(numberOfErosions));
+  fin.read(reinterpret_cast<char*>(&bytesPerRound), sizeof(bytesPerRound));
+  if(!fin || memcmp(magic, LevelsMagic, sizeof(magic)) != 0 || version != LevelsVersion ||
+     bytesPerRound != GetBytesPerRound(numberOfErosions))
+    {
+    return false;
+    }
+
+  // Check the number of edges against the rest of the file before allocating room for it, so a corrupt
+  // or truncated file is rejected instead of causing a huge allocation
+  const std::streampos headerEnd = fin.tellg();
+  fin.seekg(0, std::ios::end);
+  const uint64_t remainingBytes = static_cast<uint64_t>(fin.tellg() - headerEnd);
+  fin.seekg(headerEnd);
+  if(!fin || numberOfEdges > remainingBytes / (2 * bytesPerRound))
+    {
+    return false;
+    }
+
+  levels.NumberOfErosions = numberOfErosions;
+  std::vector<unsigned int>* rounds[2] = {&levels.ErosionRounds, &levels.DilationRounds};
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+    if(bytesPerRound == 1)
+      {
+      ReadRounds<uint8_t>(numberOfEdges, fin, *rounds[i]);
+      }
+    else if(bytesPerRound == 2)
+      {
+      ReadRounds<uint16_t>(numberOfEdges, fin, *rounds[i]);
+      }
+    else
+      {
+      ReadRounds<uint32_t>(numberOfEdges, fin, *rounds[i]);
+      }
+    }
+  return fin.good();
+}
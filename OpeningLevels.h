@@ -0,0 +1,81 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef OPENINGLEVELS_H
+#define OPENINGLEVELS_H
+
+// STL
+#include <string>
+#include <vector>
+
+// Custom
+#include "CompactGraph.h"
+#include "Types.h"
+
+// The complete history of an opening in one record per edge. Every intermediate graph of the opening
+// can be rebuilt from it by thresholding, so it replaces writing a snapshot of the graph after every step.
+struct OpeningLevels
+{
+  OpeningLevels() : NumberOfErosions(0) {}
+
+  unsigned int NumberOfErosions;
+
+  // The erosion (starting at 1) which removed each edge, or 0 if the edge was never removed.
+  std::vector<unsigned int> ErosionRounds;
+
+  // The dilation (starting at 1) which added each removed edge back, or 0 if it was not added back.
+  std::vector<unsigned int> DilationRounds;
+
+  // Whether edge 'edgeId' exists after 'numberOfErosions' erosions.
+  bool ExistsAfterErosion(const size_t edgeId, const unsigned int numberOfErosions) const
+  {
+    return ErosionRounds[edgeId] == 0 || ErosionRounds[edgeId] > numberOfErosions;
+  }
+
+  // Whether edge 'edgeId' exists after all of the erosions and 'numberOfDilations' dilations.
+  bool ExistsAfterDilation(const size_t edgeId, const unsigned int numberOfDilations) const
+  {
+    return ErosionRounds[edgeId] == 0 || (DilationRounds[edgeId] != 0 && DilationRounds[edgeId] <= numberOfDilations);
+  }
+
+  // The keep-masks of the intermediate graphs. The opened graph is GetKeepMaskAfterDilation(NumberOfErosions).
+  std::vector<bool> GetKeepMaskAfterErosion(unsigned int numberOfErosions) const;
+  std::vector<bool> GetKeepMaskAfterDilation(unsigned int numberOfDilations) const;
+};
+
+// Open 'g' with 'numberOfIterations' erosions and dilations and record the level of every edge.
+// The result is the same as OpenCompactGraphFixed.
+OpeningLevels ComputeOpeningLevelsFixed(const CompactGraph& g, unsigned int numberOfIterations,
+                                        unsigned int degreeThreshold = 1);
+
+OpeningLevels ComputeOpeningLevelsNullRemovalDifference(const CompactGraph& g, unsigned int goalSuccessiveNullDifferences,
+                                                        unsigned int degreeThreshold = 1);
+
+// Write all of the edges of 'g' once, with "erosion" and "dilation" attributes holding their levels and
+// the edges which do not survive the opening marked as invisible. The levels are in the order of boost::edges(g),
+// and std::invalid_argument is thrown if there is not one for every edge.
+void WriteOpeningLevelsDOT(const Graph& g, const OpeningLevels& levels, const std::string& fileName);
+
+// Write/read the levels alone in a compact binary file: the magic "GOLV", a format version, the number of
+// edges and erosions, then the erosion and dilation rounds of every edge in the smallest of 1, 2 or 4 bytes
+// which holds the number of erosions. All values are in the byte order of the machine which wrote the file.
+// Both return false if the file could not be written/read.
+bool WriteOpeningLevelsBinary(const OpeningLevels& levels, const std::string& fileName);
+bool ReadOpeningLevelsBinary(const std::string& fileName, OpeningLevels& levels);
+
+#endif
@@ -0,0 +1,283 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "OpeningProtocol.h"
+
+// STL
+#include <cstring>
+
+// C
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const char RequestMagic[4] = {'G', 'O', 'R', 'Q'};
+static const char ReplyMagic[4] = {'G', 'O', 'R', 'P'};
+
+// Larger payloads are rejected rather than allocated
+static const uint64_t MaximumPayloadBytes = uint64_t(1) << 36;
+
+static bool WriteAll(const int socket, const void* data, size_t numberOfBytes)
+{
+  const char* bytes = static_cast<const char*>(data);
+  while(numberOfBytes > 0)
+    {
+    // MSG_NOSIGNAL: a client which went away is an error, not a SIGPIPE
+    ssize_t written = send(socket, bytes, numberOfBytes, MSG_NOSIGNAL);
+    if(written < 0 && errno == EINTR)
+      {
+      continue;
+      }
+    if(written <= 0)
+      {
+      return false;
+      }
+    bytes += written;
+    numberOfBytes -= written;
+    }
+  return true;
+}
+
+static bool ReadAll(const int socket, void* data, size_t numberOfBytes)
+{
+  char* bytes = static_cast<char*>(data);
+  while(numberOfBytes > 0)
+    {
+    ssize_t numberRead = recv(socket, bytes, numberOfBytes, 0);
+    if(numberRead < 0 && errno == EINTR)
+      {
+      continue;
+      }
+    if(numberRead <= 0)
+      {
+      return false;
+      }
+    bytes += numberRead;
+    numberOfBytes -= numberRead;
+    }
+  return true;
+}
+
+static bool ReadPayload(const int socket, const uint64_t numberOfBytes, std::string& payload)
+{
+  if(numberOfBytes > MaximumPayloadBytes)
+    {
+    return false;
+    }
+  payload.resize(numberOfBytes);
+  return numberOfBytes == 0 || ReadAll(socket, &payload[0], numberOfBytes);
+}
+
+bool WriteRequest(const int socket, const OpeningRequest& request)
+{
+  char header[24];
+  memcpy(header, RequestMagic, 4);
+  header[4] = static_cast<char>(request.Format);
+  header[5] = static_cast<char>(request.Algorithm);
+  header[6] = static_cast<char>(request.Reply);
+  header[7] = 0;
+  memcpy(header + 8, &request.Parameter, 4);
+  memcpy(header + 12, &request.DegreeThreshold, 4);
+  uint64_t numberOfBytes = request.Payload.size();
+  memcpy(header + 16, &numberOfBytes, 8);
+  return WriteAll(socket, header, sizeof(header)) && WriteAll(socket, request.Payload.data(), numberOfBytes);
+}
+
+bool ReadRequest(const int socket, OpeningRequest& request)
+{
+  char header[24];
+  if(!ReadAll(socket, header, sizeof(header)) || memcmp(header, RequestMagic, 4) != 0)
+    {
+    return false;
+    }
+  // char may be signed, so a byte of 0x80 or more would compare as negative
+  const unsigned char* kinds = reinterpret_cast<const unsigned char*>(header + 4);
+  if(kinds[0] > EdgeListGraphFormat || kinds[1] > NullRemovalDifferenceAlgorithm || kinds[2] > GraphReply)
+    {
+    return false;
+    }
+  request.Format = static_cast<GraphFormat>(kinds[0]);
+  request.Algorithm = static_cast<OpeningAlgorithm>(kinds[1]);
+  request.Reply = static_cast<OpeningReplyKind>(kinds[2]);
+  memcpy(&request.Parameter, header + 8, 4);
+  memcpy(&request.DegreeThreshold, header + 12, 4);
+  uint64_t numberOfBytes;
+  memcpy(&numberOfBytes, header + 16, 8);
+  return ReadPayload(socket, numberOfBytes, request.Payload);
+}
+
+bool WriteReply(const int socket, const OpeningReply& reply)
+{
+  char header[16];
+  memcpy(header, ReplyMagic, 4);
+  uint32_t status = reply.Succeeded ? 0 : 1;
+  memcpy(header + 4, &status, 4);
+  uint64_t numberOfBytes = reply.Payload.size();
+  memcpy(header + 8, &numberOfBytes, 8);
+  return WriteAll(socket, header, sizeof(header)) && WriteAll(socket, reply.Payload.data(), numberOfBytes);
+}
+
+bool ReadReply(const int socket, OpeningReply& reply)
+{
+  char header[16];
+  if(!ReadAll(socket, header, sizeof(header)) || memcmp(header, ReplyMagic, 4) != 0)
+    {
+    return false;
+    }
+  uint32_t status;
+  memcpy(&status, header + 4, 4);
+  reply.Succeeded = (status == 0);
+  uint64_t numberOfBytes;
+  memcpy(&numberOfBytes, header + 8, 8);
+  return ReadPayload(socket, numberOfBytes, reply.Payload);
+}
+
+static bool CreateAddress(const std::string& path, sockaddr_un& address)
+{
+  if(path.size() >= sizeof(address.sun_path))
+    {
+    return false;
+    }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  return true;
+}
+
+int ListenOnUnixSocket(const std::string& path)
+{
+  sockaddr_un address;
+  if(!CreateAddress(path, address))
+    {
+    return -1;
+    }
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(listener < 0)
+    {
+    return -1;
+    }
+  unlink(path.c_str());
+  if(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0)
+    {
+    close(listener);
+    return -1;
+    }
+  return listener;
+}
+
+int ConnectToUnixSocket(const std::string& path)
+{
+  sockaddr_un address;
+  if(!CreateAddress(path, address))
+    {
+    return -1;
+    }
+  int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(connection < 0)
+    {
+    return -1;
+    }
+  if(connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+    close(connection);
+    return -1;
+    }
+  return connection;
+}
+
+std::string EncodeEdgeList(const EdgeArrays& edges, const uint32_t numberOfVertices)
+{
+  const uint64_t numberOfEdges = edges.NumberOfEdges;
+  const uint32_t reserved = 0;
+  std::string payload(16 + 8 * numberOfEdges, '\0');
+  memcpy(&payload[0], &numberOfEdges, 8);
+  memcpy(&payload[8], &numberOfVertices, 4);
+  memcpy(&payload[12], &reserved, 4);
+  if(numberOfEdges > 0)
+    {
+    memcpy(&payload[16], edges.Sources, 4 * numberOfEdges);
+    memcpy(&payload[16 + 4 * numberOfEdges], edges.Targets, 4 * numberOfEdges);
+    }
+  return payload;
+}
+
+bool DecodeEdgeList(const std::string& payload, EdgeArrays& edges, uint32_t& numberOfVertices)
+{
+  if(payload.size() < 16)
+    {
+    return false;
+    }
+  uint64_t numberOfEdges;
+  memcpy(&numberOfEdges, payload.data(), 8);
+  memcpy(&numberOfVertices, payload.data() + 8, 4);
+  // Check the count before multiplying it, as a forged count could overflow the expected size
+  if(numberOfEdges > (payload.size() - 16) / 8 || payload.size() != 16 + 8 * numberOfEdges)
+    {
+    return false;
+    }
+  // The payload starts at an aligned allocation, so the arrays are aligned for uint32_t
+  edges.Sources = reinterpret_cast<const uint32_t*>(payload.data() + 16);
+  edges.Targets = edges.Sources + numberOfEdges;
+  edges.NumberOfEdges = numberOfEdges;
+
+  // Every vertex id must be below numberOfVertices
+  for(uint64_t i = 0; i < 2 * numberOfEdges; ++i)
+    {
+    if(edges.Sources[i] >= numberOfVertices)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+std::string EncodeKeepMask(const std::vector<bool>& keep)
+{
+  const uint64_t numberOfEdges = keep.size();
+  std::string payload(8 + (numberOfEdges + 7) / 8, '\0');
+  memcpy(&payload[0], &numberOfEdges, 8);
+  for(uint64_t edgeId = 0; edgeId < numberOfEdges; ++edgeId)
+    {
+    if(keep[edgeId])
+      {
+      payload[8 + edgeId / 8] |= static_cast<char>(1 << (edgeId % 8));
+      }
+    }
+  return payload;
+}
+
+bool DecodeKeepMask(const std::string& payload, std::vector<bool>& keep)
+{
+  if(payload.size() < 8)
+    {
+    return false;
+    }
+  uint64_t numberOfEdges;
+  memcpy(&numberOfEdges, payload.data(), 8);
+  if(numberOfEdges > (payload.size() - 8) * 8 || payload.size() != 8 + (numberOfEdges + 7) / 8)
+    {
+    return false;
+    }
+  keep.assign(numberOfEdges, false);
+  for(uint64_t edgeId = 0; edgeId < numberOfEdges; ++edgeId)
+    {
+    keep[edgeId] = (payload[8 + edgeId / 8] >> (edgeId % 8)) & 1;
+    }
+  return true;
+}
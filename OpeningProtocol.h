@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef OPENINGPROTOCOL_H
+#define OPENINGPROTOCOL_H
+
+// The messages exchanged with GraphOpeningServer over a Unix domain socket. A client connects, then sends
+// any number of requests on the connection, each answered by one reply before the next is read.
+//
+// Request  "GORQ", u8 format, u8 algorithm, u8 reply, u8 0, u32 parameter, u32 degreeThreshold,
+//          u64 payload bytes, payload
+// Reply    "GORP", u32 status (0 if the graph was opened, otherwise the payload is an error message),
+//          u64 payload bytes, payload
+//
+// A graph payload is either the text of a .dot file or an edge list: u64 number of edges, u32 number of
+// vertices, u32 0, the source of every edge and then the target of every edge as u32. A keep-mask payload
+// is the u64 number of edges followed by one bit per edge, least significant bit first. All values are in
+// the byte order of the machine, as both ends are on the same machine. The server removes the self loops and
+// duplicate edges of a graph before opening it, so a reply covers the remaining edges, in the order of their
+// first occurrence.
+
+// STL
+#include <string>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "CompactGraph.h"
+
+enum GraphFormat
+{
+  DOTGraphFormat = 0,
+  EdgeListGraphFormat = 1
+};
+
+enum OpeningAlgorithm
+{
+  FixedIterationsAlgorithm = 0,
+  NullRemovalDifferenceAlgorithm = 1
+};
+
+// What the server sends back: the keep-mask of the opened graph, or the opened graph itself in the
+// format of the request.
+enum OpeningReplyKind
+{
+  KeepMaskReply = 0,
+  GraphReply = 1
+};
+
+struct OpeningRequest
+{
+  OpeningRequest() : Format(DOTGraphFormat), Algorithm(NullRemovalDifferenceAlgorithm), Reply(KeepMaskReply),
+                     Parameter(1), DegreeThreshold(1) {}
+
+  GraphFormat Format;
+  OpeningAlgorithm Algorithm;
+  OpeningReplyKind Reply;
+
+  // The number of iterations or the goal number of successive null differences
+  uint32_t Parameter;
+  uint32_t DegreeThreshold;
+
+  std::string Payload;
+};
+
+struct OpeningReply
+{
+  OpeningReply() : Succeeded(false) {}
+
+  bool Succeeded;
+  std::string Payload;
+};
+
+// Each of these returns false if the connection was closed or the message is malformed.
+bool WriteRequest(int socket, const OpeningRequest& request);
+bool ReadRequest(int socket, OpeningRequest& request);
+bool WriteReply(int socket, const OpeningReply& reply);
+bool ReadReply(int socket, OpeningReply& reply);
+
+// Create a socket listening at 'path', replacing a stale socket file. Returns -1 on failure.
+int ListenOnUnixSocket(const std::string& path);
+
+// Returns -1 on failure.
+int ConnectToUnixSocket(const std::string& path);
+
+// Encode the edges as an edge list payload.
+std::string EncodeEdgeList(const EdgeArrays& edges, uint32_t numberOfVertices);
+
+// Point 'edges' into an edge list payload, which must outlive it. Returns false if it is malformed.
+bool DecodeEdgeList(const std::string& payload, EdgeArrays& edges, uint32_t& numberOfVertices);
+
+std::string EncodeKeepMask(const std::vector<bool>& keep);
+bool DecodeKeepMask(const std::string& payload, std::vector<bool>& keep);
+
+#endif
@@ -0,0 +1,127 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "OpeningResultHolder.h"
+
+// STL
+#include <stdexcept>
+
+const uint64_t OpeningResultHolder::Idle;
+
+OpeningResultHolder::OpeningResultHolder(const unsigned int maximumNumberOfReaders)
+  : Current(NULL), GlobalEpoch(1), Slots(new ReaderSlot[maximumNumberOfReaders]), NumberOfSlots(maximumNumberOfReaders),
+    NumberOfPublishedSnapshots(0)
+{
+  for(unsigned int slot = 0; slot < NumberOfSlots; ++slot)
+    {
+    Slots[slot].Epoch.store(Idle);
+    Slots[slot].InUse.store(false);
+    }
+}
+
+OpeningResultHolder::~OpeningResultHolder()
+{
+  delete Current.load();
+  for(size_t i = 0; i < Retired.size(); ++i)
+    {
+    delete Retired[i].Snapshot;
+    }
+}
+
+OpeningResultHolder::Reader::Reader(OpeningResultHolder& holder) : Holder(holder), Slot(0)
+{
+  for(; Slot < Holder.NumberOfSlots; ++Slot)
+    {
+    bool inUse = false;
+    if(Holder.Slots[Slot].InUse.compare_exchange_strong(inUse, true))
+      {
+      return;
+      }
+    }
+  throw std::runtime_error("OpeningResultHolder has too many readers");
+}
+
+OpeningResultHolder::Reader::~Reader()
+{
+  Release();
+  Holder.Slots[Slot].InUse.store(false);
+}
+
+const OpeningSnapshot* OpeningResultHolder::Reader::Acquire()
+{
+  // The announcement has to be visible before the pointer is loaded, which the sequentially consistent
+  // operations guarantee. A writer which replaces the pointer after this load retires the old snapshot
+  // in this epoch or a later one, so it is not freed while the slot holds this epoch.
+  Holder.Slots[Slot].Epoch.store(Holder.GlobalEpoch.load());
+  return Holder.Current.load();
+}
+
+void OpeningResultHolder::Reader::Release()
+{
+  Holder.Slots[Slot].Epoch.store(Idle);
+}
+
+void OpeningResultHolder::Publish(std::unique_ptr<OpeningSnapshot> snapshot)
+{
+  std::lock_guard<std::mutex> lock(WriterMutex);
+  NumberOfPublishedSnapshots++;
+  snapshot->Version = NumberOfPublishedSnapshots;
+
+  const OpeningSnapshot* replaced = Current.exchange(snapshot.release());
+  if(replaced)
+    {
+    RetiredSnapshot retired = {replaced, GlobalEpoch.fetch_add(1)};
+    Retired.push_back(retired);
+    }
+  Reclaim();
+}
+
+size_t OpeningResultHolder::GetNumberOfRetiredSnapshots()
+{
+  std::lock_guard<std::mutex> lock(WriterMutex);
+  return Retired.size();
+}
+
+void OpeningResultHolder::Reclaim()
+{
+  // A snapshot retired in epoch e may be in use by a reader which announced e or earlier
+  uint64_t oldestEpoch = GlobalEpoch.load();
+  for(unsigned int slot = 0; slot < NumberOfSlots; ++slot)
+    {
+    uint64_t epoch = Slots[slot].Epoch.load();
+    if(epoch != Idle && epoch < oldestEpoch)
+      {
+      oldestEpoch = epoch;
+      }
+    }
+
+  size_t numberOfRetired = 0;
+  for(size_t i = 0; i < Retired.size(); ++i)
+    {
+    if(Retired[i].Epoch < oldestEpoch)
+      {
+      delete Retired[i].Snapshot;
+      }
+    else
+      {
+      Retired[numberOfRetired] = Retired[i];
+      numberOfRetired++;
+      }
+    }
+  Retired.resize(numberOfRetired);
+}
@@ -0,0 +1,124 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef OPENINGRESULTHOLDER_H
+#define OPENINGRESULTHOLDER_H
+
+// STL
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// An opened graph as a keep-mask and how it was computed. Published snapshots are never modified.
+struct OpeningSnapshot
+{
+  OpeningSnapshot() : NumberOfKeptEdges(0), NumberOfErosions(0), Parameter(0), DegreeThreshold(1), Version(0) {}
+
+  std::vector<bool> Keep;
+  size_t NumberOfKeptEdges;
+  unsigned int NumberOfErosions;
+
+  // The number of iterations or the goal number of successive null differences
+  unsigned int Parameter;
+  unsigned int DegreeThreshold;
+
+  // Set by OpeningResultHolder::Publish: 1 for the first snapshot, then counting up
+  uint64_t Version;
+};
+
+// Holds the latest opening of a graph, which many threads read while another thread replaces it.
+// Publishing swaps an atomic pointer, so readers never wait and never copy the keep-mask. A replaced
+// snapshot is freed once no reader can still be using it, which is tracked with epochs: every reader
+// announces the epoch in which it started reading, and a snapshot replaced in epoch e is freed once
+// every reader is idle or has announced a later epoch.
+class OpeningResultHolder
+{
+public:
+  explicit OpeningResultHolder(unsigned int maximumNumberOfReaders = 64);
+
+  // There must not be any readers left.
+  ~OpeningResultHolder();
+
+  // The registration of one reader thread. It must not be shared between threads.
+  class Reader
+  {
+  public:
+    // Throws std::runtime_error if the holder has maximumNumberOfReaders readers already.
+    explicit Reader(OpeningResultHolder& holder);
+    ~Reader();
+
+    // The current snapshot (NULL before the first Publish), which stays valid until Release() or the
+    // next Acquire(). This does not wait for the writer.
+    const OpeningSnapshot* Acquire();
+
+    void Release();
+
+  private:
+    Reader(const Reader&);
+    Reader& operator=(const Reader&);
+
+    OpeningResultHolder& Holder;
+    unsigned int Slot;
+  };
+
+  // Make 'snapshot' the current one and free the replaced snapshots no reader can see any more.
+  // Concurrent writers are serialized.
+  void Publish(std::unique_ptr<OpeningSnapshot> snapshot);
+
+  // The number of replaced snapshots which are not freed yet, because a reader may still be using them.
+  size_t GetNumberOfRetiredSnapshots();
+
+private:
+  OpeningResultHolder(const OpeningResultHolder&);
+  OpeningResultHolder& operator=(const OpeningResultHolder&);
+
+  // The epoch of a reader which is not reading
+  static const uint64_t Idle = 0;
+
+  // One reader's announced epoch, padded to the size of a cache line so readers do not slow each other down
+  struct ReaderSlot
+  {
+    std::atomic<uint64_t> Epoch;
+    std::atomic<bool> InUse;
+    char Padding[64 - sizeof(std::atomic<uint64_t>) - sizeof(std::atomic<bool>)];
+  };
+
+  struct RetiredSnapshot
+  {
+    const OpeningSnapshot* Snapshot;
+    uint64_t Epoch;
+  };
+
+  void Reclaim();
+
+  std::atomic<const OpeningSnapshot*> Current;
+  std::atomic<uint64_t> GlobalEpoch;
+  std::unique_ptr<ReaderSlot[]> Slots;
+  unsigned int NumberOfSlots;
+
+  // Only used by writers
+  std::mutex WriterMutex;
+  std::vector<RetiredSnapshot> Retired;
+  uint64_t NumberOfPublishedSnapshots;
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "OpeningStatistics.h"
+
+// STL
+#include <fstream>
+
+static void WriteRoundsJSON(const std::vector<RoundStatistics>& rounds, const std::string& edgesName, std::ostream& stream)
+{
+  stream << "[";
+  for(unsigned int i = 0; i < rounds.size(); ++i)
+    {
+    if(i > 0)
+      {
+      stream << ",";
+      }
+    stream << std::endl << "    {\"seconds\": " << rounds[i].Seconds
+           << ", \"frontierSize\": " << rounds[i].FrontierSize
+           << ", \"" << edgesName << "\": " << rounds[i].NumberOfEdges << "}";
+    }
+  if(!rounds.empty())
+    {
+    stream << std::endl << "  ";
+    }
+  stream << "]";
+}
+
+void WriteStatisticsJSON(const OpeningStatistics& statistics, std::ostream& stream)
+{
+  double erosionSeconds = 0;
+  for(unsigned int i = 0; i < statistics.Erosions.size(); ++i)
+    {
+    erosionSeconds += statistics.Erosions[i].Seconds;
+    }
+  double dilationSeconds = 0;
+  for(unsigned int i = 0; i < statistics.Dilations.size(); ++i)
+    {
+    dilationSeconds += statistics.Dilations[i].Seconds;
+    }
+
+  stream << "{" << std::endl;
+  stream << "  \"loadSeconds\": " << statistics.LoadSeconds << "," << std::endl;
+  stream << "  \"fromCache\": " << (statistics.FromCache ? "true" : "false") << "," << std::endl;
+  stream << "  \"cacheSeconds\": " << statistics.CacheSeconds << "," << std::endl;
+  stream << "  \"buildSeconds\": " << statistics.BuildSeconds << "," << std::endl;
+  stream << "  \"removedEdges\": " << statistics.NumberOfRemovedEdges << "," << std::endl;
+  stream << "  \"findEndPointsSeconds\": " << statistics.FindEndPointsSeconds << "," << std::endl;
+  stream << "  \"erosionSeconds\": " << erosionSeconds << "," << std::endl;
+  stream << "  \"dilationSeconds\": " << dilationSeconds << "," << std::endl;
+  stream << "  \"writeSeconds\": " << statistics.WriteSeconds << "," << std::endl;
+  stream << "  \"peakWorkspaceBytes\": " << statistics.PeakWorkspaceBytes << "," << std::endl;
+  stream << "  \"erosions\": ";
+  WriteRoundsJSON(statistics.Erosions, "edgesRemoved", stream);
+  stream << "," << std::endl;
+  stream << "  \"dilations\": ";
+  WriteRoundsJSON(statistics.Dilations, "edgesRestored", stream);
+  stream << std::endl << "}" << std::endl;
+}
+
+void WriteStatisticsJSON(const OpeningStatistics& statistics, const std::string& fileName)
+{
+  std::ofstream fout(fileName.c_str());
+  WriteStatisticsJSON(statistics, fout);
+}
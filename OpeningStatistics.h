@@ -0,0 +1,128 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef OPENINGSTATISTICS_H
+#define OPENINGSTATISTICS_H
+
+// STL
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Measures the wall clock time since it was created or last restarted.
+class Timer
+{
+public:
+  Timer() : Start(std::chrono::steady_clock::now()) {}
+
+  void Restart()
+  {
+    Start = std::chrono::steady_clock::now();
+  }
+
+  double GetElapsedSeconds() const
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point Start;
+};
+
+// What happened in a single erosion or dilation.
+struct RoundStatistics
+{
+  double Seconds;
+
+  // The number of end points which were processed in this round.
+  unsigned int FrontierSize;
+
+  // The number of edges removed (erosion) or added back (dilation) in this round.
+  unsigned int NumberOfEdges;
+};
+
+// Timings and counters of a complete opening. Every opening function takes an optional pointer to one of
+// these and fills in the parts it performs; loading and writing are filled in by the caller.
+struct OpeningStatistics
+{
+  OpeningStatistics() : LoadSeconds(0), FromCache(false), CacheSeconds(0), BuildSeconds(0), NumberOfRemovedEdges(0),
+                        FindEndPointsSeconds(0), WriteSeconds(0), PeakWorkspaceBytes(0) {}
+
+  double LoadSeconds;
+
+  // Whether the result was taken from an OpeningCache, in which case nothing else below is filled in, and the
+  // time spent looking it up in (and adding it to) the cache.
+  bool FromCache;
+  double CacheSeconds;
+
+  // The time spent building an internal representation of the graph (such as a CompactGraph), if any.
+  double BuildSeconds;
+
+  // The number of self loops and duplicate edges removed from the input before opening it, see CleanEdgeArrays.
+  size_t NumberOfRemovedEdges;
+
+  double FindEndPointsSeconds;
+  std::vector<RoundStatistics> Erosions;
+  std::vector<RoundStatistics> Dilations;
+  double WriteSeconds;
+
+  // The largest amount of memory used by the opening at any point, not counting the input graph.
+  size_t PeakWorkspaceBytes;
+
+  void AddErosion(const double seconds, const unsigned int frontierSize, const unsigned int numberOfEdges)
+  {
+    RoundStatistics round = {seconds, frontierSize, numberOfEdges};
+    Erosions.push_back(round);
+  }
+
+  void AddDilation(const double seconds, const unsigned int frontierSize, const unsigned int numberOfEdges)
+  {
+    RoundStatistics round = {seconds, frontierSize, numberOfEdges};
+    Dilations.push_back(round);
+  }
+
+  void UpdatePeakWorkspaceBytes(const size_t bytes)
+  {
+    if(bytes > PeakWorkspaceBytes)
+      {
+      PeakWorkspaceBytes = bytes;
+      }
+  }
+};
+
+// The number of bytes used by the elements a vector has allocated room for.
+template <typename T>
+size_t GetAllocatedBytes(const std::vector<T>& v)
+{
+  return v.capacity() * sizeof(T);
+}
+
+inline size_t GetAllocatedBytes(const std::vector<bool>& v)
+{
+  return v.capacity() / 8;
+}
+
+// Write the statistics as a JSON object.
+void WriteStatisticsJSON(const OpeningStatistics& statistics, std::ostream& stream);
+
+// Write the statistics as a JSON object to a file.
+void WriteStatisticsJSON(const OpeningStatistics& statistics, const std::string& fileName);
+
+#endif
@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Ranges smaller than this are not worth starting a thread for.
+const size_t MinimumItemsPerThread = 1 << 16;
+
+// Determine how many threads to use for 'numberOfItems' items of work.
+inline unsigned int GetNumberOfThreads(const size_t numberOfItems)
+{
+  size_t numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+  numberOfThreads = std::min(numberOfThreads, numberOfItems / MinimumItemsPerThread + 1);
+  return numberOfThreads;
+}
+
+// Split [begin, end) into one contiguous chunk per thread and call function(chunkBegin, chunkEnd, threadId)
+// on each of them. Returns when all of the chunks are done. Small ranges are run on the calling thread.
+template <typename TFunction>
+void ParallelFor(const size_t begin, const size_t end, TFunction function)
+{
+  unsigned int numberOfThreads = GetNumberOfThreads(end - begin);
+  if(numberOfThreads <= 1)
+    {
+    function(begin, end, 0u);
+    return;
+    }
+
+  std::vector<std::thread> threads;
+  size_t chunkSize = (end - begin + numberOfThreads - 1) / numberOfThreads;
+  for(unsigned int threadId = 0; threadId < numberOfThreads; ++threadId)
+    {
+    size_t chunkBegin = std::min(end, begin + threadId * chunkSize);
+    size_t chunkEnd = std::min(end, chunkBegin + chunkSize);
+    threads.push_back(std::thread(function, chunkBegin, chunkEnd, threadId));
+    }
+  for(unsigned int threadId = 0; threadId < threads.size(); ++threadId)
+    {
+    threads[threadId].join();
+    }
+}
+
+// Sort 'values' with one std::sort per thread, followed by rounds of pairwise merges of the sorted chunks.
+template <typename T>
+void ParallelSort(std::vector<T>& values)
+{
+  const unsigned int numberOfChunks = GetNumberOfThreads(values.size());
+  if(numberOfChunks <= 1)
+    {
+    std::sort(values.begin(), values.end());
+    return;
+    }
+
+  std::vector<size_t> bounds(numberOfChunks + 1);
+  for(unsigned int chunk = 0; chunk <= numberOfChunks; ++chunk)
+    {
+    bounds[chunk] = values.size() * chunk / numberOfChunks;
+    }
+  ParallelFor(0, values.size(), [&](size_t, size_t, unsigned int threadId)
+    {
+    std::sort(values.begin() + bounds[threadId], values.begin() + bounds[threadId + 1]);
+    });
+
+  // Merge neighboring chunks until one is left
+  for(unsigned int width = 1; width < numberOfChunks; width *= 2)
+    {
+    std::vector<std::thread> threads;
+    for(unsigned int chunk = 0; chunk + width < numberOfChunks; chunk += 2 * width)
+      {
+      const size_t first = bounds[chunk];
+      const size_t middle = bounds[chunk + width];
+      const size_t last = bounds[std::min(chunk + 2 * width, numberOfChunks)];
+      threads.push_back(std::thread([&values, first, middle, last]()
+        {
+        std::inplace_merge(values.begin() + first, values.begin() + middle, values.begin() + last);
+        }));
+      }
+    for(unsigned int i = 0; i < threads.size(); ++i)
+      {
+      threads[i].join();
+      }
+    }
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "ParentArrayTree.h"
+
+// STL
+#include <algorithm>
+
+const uint32_t ParentArrayTree::NoParent;
+
+size_t GetAllocatedBytes(const ParentArrayTree& tree)
+{
+  return (tree.Parents.capacity() + tree.ChildOffsets.capacity() + tree.Children.capacity()) * sizeof(uint32_t);
+}
+
+bool CreateParentArrayTree(const EdgeArrays& edges, ParentArrayTree& tree, uint32_t numberOfVertices)
+{
+  if(numberOfVertices == 0)
+    {
+    for(size_t edgeId = 0; edgeId < edges.NumberOfEdges; ++edgeId)
+      {
+      numberOfVertices = std::max(numberOfVertices, std::max(edges.Sources[edgeId], edges.Targets[edgeId]) + 1);
+      }
+    }
+
+  // A forest has fewer edges than vertices
+  if(edges.NumberOfEdges >= numberOfVertices && edges.NumberOfEdges > 0)
+    {
+    return false;
+    }
+
+  // The XOR of the neighbors becomes the parent of every vertex but the roots
+  std::vector<uint32_t> degrees(numberOfVertices, 0);
+  std::vector<uint32_t> parents(numberOfVertices, 0);
+  for(size_t edgeId = 0; edgeId < edges.NumberOfEdges; ++edgeId)
+    {
+    const uint32_t source = edges.Sources[edgeId];
+    const uint32_t target = edges.Targets[edgeId];
+    degrees[source]++;
+    degrees[target]++;
+    parents[source] ^= target;
+    parents[target] ^= source;
+    }
+
+  // Cut off every leaf, and follow the leaves it creates as long as they have smaller ids, as the larger
+  // ones are reached by the outer loop
+  std::vector<bool> isRoot(numberOfVertices, true);
+  for(uint32_t v = 0; v < numberOfVertices; ++v)
+    {
+    uint32_t leaf = v;
+    while(degrees[leaf] == 1)
+      {
+      const uint32_t parent = parents[leaf];
+      degrees[leaf] = 0;
+      isRoot[leaf] = false;
+      degrees[parent]--;
+      parents[parent] ^= leaf;
+      if(parent > v)
+        {
+        break;
+        }
+      leaf = parent;
+      }
+    }
+
+  for(uint32_t v = 0; v < numberOfVertices; ++v)
+    {
+    if(degrees[v] > 0)
+      {
+      return false;
+      }
+    if(isRoot[v])
+      {
+      parents[v] = ParentArrayTree::NoParent;
+      }
+    }
+  std::vector<uint32_t>().swap(degrees);
+  std::vector<bool>().swap(isRoot);
+
+  tree.NumberOfVertices = numberOfVertices;
+  tree.NumberOfEdges = numberOfVertices;
+  // Count the children, sum up the counts so ChildOffsets[v] is the end of the children of v, and move it
+  // back to their start while filling them in from the largest id down, which keeps every list sorted
+  tree.ChildOffsets.assign(static_cast<size_t>(numberOfVertices) + 1, 0);
+  for(uint32_t v = 0; v < numberOfVertices; ++v)
+    {
+    if(parents[v] != ParentArrayTree::NoParent)
+      {
+      tree.ChildOffsets[parents[v]]++;
+      }
+    }
+  for(uint32_t v = 1; v <= numberOfVertices; ++v)
+    {
+    tree.ChildOffsets[v] += tree.ChildOffsets[v - 1];
+    }
+  tree.Children.resize(edges.NumberOfEdges);
+  for(uint32_t v = numberOfVertices; v-- > 0;)
+    {
+    if(parents[v] != ParentArrayTree::NoParent)
+      {
+      tree.Children[--tree.ChildOffsets[parents[v]]] = v;
+      }
+    }
+  tree.Parents.swap(parents);
+  return true;
+}
+
+std::vector<bool> MapKeepMaskBack(const std::vector<bool>& keep, const ParentArrayTree& tree, const EdgeArrays& edges)
+{
+  std::vector<bool> inputKeep(edges.NumberOfEdges);
+  for(size_t edgeId = 0; edgeId < edges.NumberOfEdges; ++edgeId)
+    {
+    const uint32_t source = edges.Sources[edgeId];
+    const uint32_t child = tree.Parents[source] == edges.Targets[edgeId] ? source : edges.Targets[edgeId];
+    inputKeep[edgeId] = keep[child];
+    }
+  return inputKeep;
+}
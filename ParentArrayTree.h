@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef PARENTARRAYTREE_H
+#define PARENTARRAYTREE_H
+
+// STL
+#include <cstddef>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "CompactGraph.h"
+
+// A read-only adjacency of a forest which stores every edge once: each vertex knows its parent, and the
+// children of every vertex are listed together. This takes 12 bytes per edge instead of the 20 of a
+// CompactGraph. The edge between v and its parent has the id v, so the ids of the roots are unused and a
+// keep-mask has one entry per vertex; MapKeepMaskBack maps it onto the input edges. It has the interface
+// of a CompactAdjacency, so an OpeningEngine runs on it directly.
+struct ParentArrayTree
+{
+  typedef uint32_t IndexType;
+
+  // The parent of a root
+  static const uint32_t NoParent = 0xffffffff;
+
+  uint32_t NumberOfVertices;
+
+  // The size of the edge id range, which is NumberOfVertices
+  uint32_t NumberOfEdges;
+
+  std::vector<uint32_t> Parents;
+
+  // The children of vertex v are [ChildOffsets[v], ChildOffsets[v+1]) of Children, in increasing order.
+  std::vector<uint32_t> ChildOffsets;
+  std::vector<uint32_t> Children;
+
+  uint32_t Degree(const uint32_t v) const
+  {
+    return (Parents[v] != NoParent) + ChildOffsets[v + 1] - ChildOffsets[v];
+  }
+
+  // Call visitor(neighbor, edgeId) for every edge of v, in increasing edge id order. The edge to a child
+  // has the id of the child, and the edge to the parent the id of v.
+  template <typename TVisitor>
+  void ForEachNeighbor(const uint32_t v, TVisitor visitor) const
+  {
+    uint32_t slot = ChildOffsets[v];
+    const uint32_t end = ChildOffsets[v + 1];
+    for(; slot < end && Children[slot] < v; ++slot)
+      {
+      visitor(Children[slot], Children[slot]);
+      }
+    if(Parents[v] != NoParent)
+      {
+      visitor(Parents[v], v);
+      }
+    for(; slot < end; ++slot)
+      {
+      visitor(Children[slot], Children[slot]);
+      }
+  }
+};
+
+// The number of bytes allocated by a ParentArrayTree.
+size_t GetAllocatedBytes(const ParentArrayTree& tree);
+
+// Create a ParentArrayTree from edge arrays if they form a forest (no cycles, self loops or duplicate edges),
+// otherwise return false. Leaves are cut off one after another, knowing only the degree and the XOR of the
+// neighbors of every vertex, so the only neighbor of a leaf is that XOR and it becomes the parent. Whatever
+// is left over has a cycle. The last vertex of every tree becomes its root. If 'numberOfVertices' is 0 it is
+// determined from the largest vertex id in 'edges'.
+bool CreateParentArrayTree(const EdgeArrays& edges, ParentArrayTree& tree, uint32_t numberOfVertices = 0);
+
+// Map a keep-mask over the edge ids of 'tree' onto 'edges', the arrays it was created from.
+std::vector<bool> MapKeepMaskBack(const std::vector<bool>& keep, const ParentArrayTree& tree, const EdgeArrays& edges);
+
+#endif
@@ -0,0 +1,162 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// This program builds the Euclidean minimum spanning tree of a point cloud (for example the edge points of a
+// range image), opens it, and writes the result to a file without creating a Graph. With --mst=mst.dot the
+// spanning tree itself is written as well, and with --chains=chains.txt the branch-free chains of the result
+// are written as polylines: one x y z line per vertex and an empty line after every chain. With --stream=tree.txt
+// the spanning tree is written as a parent-pointer stream in depth first order for StreamingTreeOpeningExample.
+
+// STL
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Custom
+#include "ChainExtraction.h"
+#include "EuclideanMST.h"
+#include "GraphOpeningPeeling.h"
+#include "OpeningStatistics.h"
+#include "StreamingTreeOpening.h"
+
+// Write the edges which are set in 'keep' (all of them if it is empty) in the format of boost::write_graphviz
+static void WriteEdges(const size_t numberOfVertices, const std::vector<uint32_t>& sources,
+                       const std::vector<uint32_t>& targets, const std::vector<bool>& keep, const std::string& fileName)
+{
+  std::ofstream fout(fileName.c_str());
+  fout << "graph G {" << std::endl;
+  for(size_t v = 0; v < numberOfVertices; ++v)
+    {
+    fout << v << ";" << std::endl;
+    }
+  for(size_t edgeId = 0; edgeId < sources.size(); ++edgeId)
+    {
+    if(keep.empty() || keep[edgeId])
+      {
+      fout << sources[edgeId] << "--" << targets[edgeId] << " ;" << std::endl;
+      }
+    }
+  fout << "}" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+  // Separate the options from the required arguments
+  std::vector<std::string> arguments;
+  std::string mstFileName;
+  std::string chainsFileName;
+  std::string streamFileName;
+  for(int i = 1; i < argc; ++i)
+    {
+    std::string argument = argv[i];
+    if(argument.compare(0, 6, "--mst=") == 0)
+      {
+      mstFileName = argument.substr(6);
+      }
+    else if(argument.compare(0, 9, "--chains=") == 0)
+      {
+      chainsFileName = argument.substr(9);
+      }
+    else if(argument.compare(0, 9, "--stream=") == 0)
+      {
+      streamFileName = argument.substr(9);
+      }
+    else
+      {
+      arguments.push_back(argument);
+      }
+    }
+
+  // Verify arguments
+  if(arguments.size() < 3)
+    {
+    std::cerr << "Required arguments: points.xyz|points.bin numberOfIterations output.dot [--mst=mst.dot] [--chains=chains.txt] [--stream=tree.txt]" << std::endl;
+    return -1;
+    }
+
+  // Parse arguments
+  std::string inputFileName = arguments[0];
+
+  unsigned int numberOfIterations = 0;
+  std::stringstream ss(arguments[1]);
+  ss >> numberOfIterations;
+
+  std::string outputFileName = arguments[2];
+
+  // Output arguments
+  std::cout << "Input: " << inputFileName << std::endl;
+  std::cout << "Number of iterations: " << numberOfIterations << std::endl;
+  std::cout << "Output: " << outputFileName << std::endl;
+
+  Timer timer;
+  PointCloud points;
+  if(!ReadPointCloud(inputFileName, points))
+    {
+    std::cerr << "Could not read " << inputFileName << std::endl;
+    return -1;
+    }
+  std::cout << "Read " << points.GetNumberOfPoints() << " points in " << timer.GetElapsedSeconds() << " s" << std::endl;
+
+  timer.Restart();
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> targets;
+  ComputeEuclideanMST(points, sources, targets);
+  std::cout << "Built the minimum spanning tree in " << timer.GetElapsedSeconds() << " s" << std::endl;
+
+  timer.Restart();
+  EdgeArrays edges;
+  edges.Sources = sources.data();
+  edges.Targets = targets.data();
+  edges.NumberOfEdges = sources.size();
+  CompactGraph tree = CreateCompactGraph(edges, points.GetNumberOfPoints());
+  std::vector<bool> keep = OpenCompactGraphFixed(tree, numberOfIterations);
+  std::cout << "Opened the tree in " << timer.GetElapsedSeconds() << " s" << std::endl;
+
+  if(!chainsFileName.empty())
+    {
+    timer.Restart();
+    Chains chains = ExtractChains(tree, keep);
+    GatherChainPoints(points, chains);
+    std::cout << "Extracted " << chains.GetNumberOfChains() << " chains in " << timer.GetElapsedSeconds() << " s" << std::endl;
+
+    std::ofstream fout(chainsFileName.c_str());
+    for(size_t c = 0; c < chains.GetNumberOfChains(); ++c)
+      {
+      for(uint32_t i = chains.Offsets[c]; i < chains.Offsets[c + 1]; ++i)
+        {
+        fout << chains.Points[3 * i] << " " << chains.Points[3 * i + 1] << " " << chains.Points[3 * i + 2] << std::endl;
+        }
+      fout << std::endl;
+      }
+    }
+
+  if(!mstFileName.empty())
+    {
+    WriteEdges(points.GetNumberOfPoints(), sources, targets, std::vector<bool>(), mstFileName);
+    }
+  if(!streamFileName.empty())
+    {
+    std::ofstream fout(streamFileName.c_str());
+    WriteParentStream(tree, fout);
+    }
+  WriteEdges(points.GetNumberOfPoints(), sources, targets, keep, outputFileName);
+
+  return EXIT_SUCCESS;
+}
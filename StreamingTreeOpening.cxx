@@ -0,0 +1,325 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "StreamingTreeOpening.h"
+
+// STL
+#include <algorithm>
+#include <stdexcept>
+
+const uint32_t StreamingTreeOpening::NoParent;
+
+// The classes are the length of the longest path leaving a subtree through its root: 0 (a root) to k + 1,
+// and k + 2 for anything longer. Every test below compares such a length with k or k + 1.
+
+StreamingTreeOpening::StreamingTreeOpening(unsigned int numberOfIterations, const EdgeCallback& keptEdge) :
+  NumberOfIterations(numberOfIterations), NumberOfClasses(numberOfIterations + 3), KeptEdge(keptEdge),
+  NumberOfPendingEdges(0), PeakNumberOfPendingEdges(0), MaximumDepth(0)
+{
+}
+
+void StreamingTreeOpening::AddVertex(const uint32_t vertex, const uint32_t parent)
+{
+  if(parent == NoParent)
+    {
+    Finish();
+    }
+  else
+    {
+    while(!Stack.empty() && Stack.back().Vertex != parent)
+      {
+      FinishVertex();
+      }
+    if(Stack.empty())
+      {
+      throw std::runtime_error("StreamingTreeOpening: the parent of a vertex was not read before it in depth first order");
+      }
+    }
+
+  // Without erosions every edge is kept
+  if(NumberOfIterations == 0 && parent != NoParent)
+    {
+    KeptEdge(vertex, parent);
+    }
+
+  Frame frame;
+  frame.Vertex = vertex;
+  frame.Parent = parent;
+  frame.Longest = 0;
+  frame.SecondLongest = 0;
+  Stack.push_back(frame);
+  MaximumDepth = std::max(MaximumDepth, Stack.size());
+}
+
+void StreamingTreeOpening::Finish()
+{
+  while(!Stack.empty())
+    {
+    FinishVertex();
+    }
+}
+
+void StreamingTreeOpening::AddPendingEdges(const size_t numberOfEdges)
+{
+  NumberOfPendingEdges += numberOfEdges;
+  PeakNumberOfPendingEdges = std::max(PeakNumberOfPendingEdges, NumberOfPendingEdges);
+}
+
+void StreamingTreeOpening::RemovePendingEdges(EdgeList& edges, const bool keep)
+{
+  if(keep)
+    {
+    for(size_t i = 0; i < edges.size(); ++i)
+      {
+      KeptEdge(edges[i].first, edges[i].second);
+      }
+    }
+  NumberOfPendingEdges -= edges.size();
+  EdgeList().swap(edges);
+}
+
+void StreamingTreeOpening::AddGroup(std::vector<PendingGroup>& groups, std::vector<uint8_t>& fates, EdgeList& edges,
+                                    const bool isRoot)
+{
+  if(edges.empty())
+    {
+    return;
+    }
+
+  // The edges of a tree whose core is empty are not kept
+  if(isRoot)
+    {
+    RemovePendingEdges(edges, fates[0] == KeepEdge);
+    return;
+    }
+
+  // The fate of a subtree other than the root's is only asked for classes 1 and up
+  bool isDecided = fates[1] != InheritFate;
+  for(unsigned int c = 2; c < NumberOfClasses && isDecided; ++c)
+    {
+    isDecided = fates[c] == fates[1];
+    }
+  if(isDecided)
+    {
+    RemovePendingEdges(edges, fates[1] == KeepEdge);
+    return;
+    }
+
+  for(size_t i = 0; i < groups.size(); ++i)
+    {
+    if(groups[i].Fates == fates)
+      {
+      EdgeList& groupEdges = groups[i].Edges;
+      if(groupEdges.size() < edges.size())
+        {
+        groupEdges.swap(edges);
+        }
+      groupEdges.insert(groupEdges.end(), edges.begin(), edges.end());
+      EdgeList().swap(edges);
+      return;
+      }
+    }
+
+  groups.push_back(PendingGroup());
+  groups.back().Fates.swap(fates);
+  groups.back().Edges.swap(edges);
+}
+
+void StreamingTreeOpening::FinishVertex()
+{
+  Frame frame;
+  std::swap(frame, Stack.back());
+  Stack.pop_back();
+
+  if(NumberOfIterations == 0)
+    {
+    return;
+    }
+
+  const uint32_t k = NumberOfIterations;
+  const bool isRoot = frame.Parent == NoParent;
+  const unsigned int firstClass = isRoot ? 0 : 1;
+  const unsigned int lastClass = isRoot ? 0 : NumberOfClasses - 1;
+  const size_t numberOfSubtrees = frame.CoreSubtrees.size();
+
+  // For every class of this vertex: the fate of a non-core edge at it, and for every core subtree the class
+  // of its root and the fate of the edge to it
+  std::vector<uint8_t> anchors(NumberOfClasses, InheritFate);
+  std::vector<std::vector<uint32_t> > subtreeClasses(numberOfSubtrees, std::vector<uint32_t>(NumberOfClasses, 0));
+  std::vector<std::vector<uint8_t> > edgeFates(numberOfSubtrees, std::vector<uint8_t>(NumberOfClasses, InheritFate));
+  std::vector<bool> isCoreEdge(numberOfSubtrees);
+  for(unsigned int c = firstClass; c <= lastClass; ++c)
+    {
+    // The edge to the parent is in the core if both of its sides have a path of k edges
+    unsigned int coreDegree = (frame.Longest >= k && c >= k + 1) ? 1 : 0;
+    uint8_t subtreeAnchor = InheritFate;
+    for(size_t i = 0; i < numberOfSubtrees; ++i)
+      {
+      const Subtree& subtree = frame.CoreSubtrees[i];
+      const uint32_t otherLongest = subtree.BranchLength == frame.Longest ? frame.SecondLongest : frame.Longest;
+      const uint32_t up = std::max(otherLongest, static_cast<uint32_t>(c));
+      subtreeClasses[i][c] = std::min(up + 1, k + 2);
+      isCoreEdge[i] = subtree.BranchLength >= k + 1 && up >= k;
+      if(isCoreEdge[i])
+        {
+        coreDegree++;
+        }
+      // The core is connected, so if this vertex is not in it at most one subtree has a core vertex
+      if(subtree.Anchors[subtreeClasses[i][c]] != InheritFate)
+        {
+        subtreeAnchor = subtree.Anchors[subtreeClasses[i][c]];
+        }
+      }
+
+    // Only the branches hanging from a leaf of the core grow back
+    if(coreDegree > 0)
+      {
+      anchors[c] = coreDegree == 1 ? KeepEdge : DropEdge;
+      }
+    else
+      {
+      anchors[c] = subtreeAnchor;
+      }
+
+    for(size_t i = 0; i < numberOfSubtrees; ++i)
+      {
+      edgeFates[i][c] = isCoreEdge[i] ? static_cast<uint8_t>(KeepEdge) : anchors[c];
+      }
+    }
+
+  std::vector<PendingGroup> groups;
+
+  std::vector<uint8_t> plainFates(anchors);
+  AddGroup(groups, plainFates, frame.PlainEdges, isRoot);
+
+  for(size_t i = 0; i < numberOfSubtrees; ++i)
+    {
+    Subtree& subtree = frame.CoreSubtrees[i];
+    for(size_t g = 0; g < subtree.Groups.size(); ++g)
+      {
+      std::vector<uint8_t> fates(NumberOfClasses, InheritFate);
+      for(unsigned int c = firstClass; c <= lastClass; ++c)
+        {
+        fates[c] = subtree.Groups[g].Fates[subtreeClasses[i][c]];
+        if(fates[c] == InheritFate)
+          {
+          fates[c] = edgeFates[i][c];
+          }
+        }
+      AddGroup(groups, fates, subtree.Groups[g].Edges, isRoot);
+      }
+
+    EdgeList edge(1, std::make_pair(subtree.Vertex, frame.Vertex));
+    AddPendingEdges(1);
+    AddGroup(groups, edgeFates[i], edge, isRoot);
+    }
+
+  if(isRoot)
+    {
+    return;
+    }
+
+  Frame& parent = Stack.back();
+  const uint32_t branchLength = std::min(frame.Longest + 1, k + 2);
+  if(branchLength > parent.Longest)
+    {
+    parent.SecondLongest = parent.Longest;
+    parent.Longest = branchLength;
+    }
+  else if(branchLength > parent.SecondLongest)
+    {
+    parent.SecondLongest = branchLength;
+    }
+
+  // Without a core vertex every pending edge inherits the fate of the edge to the parent, so the
+  // subtree joins the plain edges of the parent
+  bool hasCore = false;
+  for(unsigned int c = 1; c < NumberOfClasses; ++c)
+    {
+    hasCore = hasCore || anchors[c] != InheritFate;
+    }
+  for(size_t g = 0; g < groups.size() && !hasCore; ++g)
+    {
+    for(unsigned int c = 1; c < NumberOfClasses; ++c)
+      {
+      hasCore = hasCore || groups[g].Fates[c] != InheritFate;
+      }
+    }
+
+  if(!hasCore)
+    {
+    EdgeList& plainEdges = parent.PlainEdges;
+    for(size_t g = 0; g < groups.size(); ++g)
+      {
+      if(plainEdges.size() < groups[g].Edges.size())
+        {
+        plainEdges.swap(groups[g].Edges);
+        }
+      plainEdges.insert(plainEdges.end(), groups[g].Edges.begin(), groups[g].Edges.end());
+      }
+    plainEdges.push_back(std::make_pair(frame.Vertex, frame.Parent));
+    AddPendingEdges(1);
+    return;
+    }
+
+  parent.CoreSubtrees.push_back(Subtree());
+  Subtree& subtree = parent.CoreSubtrees.back();
+  subtree.Vertex = frame.Vertex;
+  subtree.BranchLength = branchLength;
+  subtree.Anchors.swap(anchors);
+  subtree.Groups.swap(groups);
+}
+
+void WriteParentStream(const CompactGraph& forest, std::ostream& stream)
+{
+  std::vector<bool> visited(forest.NumberOfVertices, false);
+  std::vector<std::pair<uint32_t, uint32_t> > stack;
+  for(uint32_t root = 0; root < forest.NumberOfVertices; ++root)
+    {
+    if(visited[root])
+      {
+      continue;
+      }
+    stack.push_back(std::make_pair(root, StreamingTreeOpening::NoParent));
+    while(!stack.empty())
+      {
+      const uint32_t vertex = stack.back().first;
+      const uint32_t parent = stack.back().second;
+      stack.pop_back();
+      visited[vertex] = true;
+      if(parent == StreamingTreeOpening::NoParent)
+        {
+        stream << vertex << " -1\n";
+        }
+      else
+        {
+        stream << vertex << " " << parent << "\n";
+        }
+
+      // Pushed in reverse so the children are written in the order of their edges
+      for(uint32_t slot = forest.Offsets[vertex + 1]; slot > forest.Offsets[vertex]; --slot)
+        {
+        const uint32_t neighbor = forest.Neighbors[slot - 1];
+        if(neighbor != parent)
+          {
+          stack.push_back(std::make_pair(neighbor, vertex));
+          }
+        }
+      }
+    }
+}
@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef STREAMINGTREEOPENING_H
+#define STREAMINGTREEOPENING_H
+
+// STL
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "CompactGraph.h"
+
+// Opens a forest with a fixed number of iterations (and a degree threshold of 1) while it is read as a
+// stream of (vertex, parent) records in depth first preorder, so the forest is never stored. The kept
+// edges are the same as those of OpenGraphFixedTracking on the whole forest.
+//
+// After k erosions of a tree only its core is left: the edges whose both sides contain a path of at
+// least k edges. The dilations then grow back every branch hanging from a leaf of the core, and nothing
+// else. So an edge's fate depends on the heights of the subtrees around it and on the nearest core
+// vertex, which may lie in a part of the stream that is not read yet. The fate of the edges of a finished
+// subtree only depends on the longest path leaving it through its root, and only through k + 3 classes of
+// that length, so each pending edge carries its fate for every class. Edges sharing a fate table are
+// grouped, and a group is emitted or dropped as soon as its fate no longer depends on the class.
+//
+// The memory is proportional to the depth of the tree plus the number of pending edges: those whose
+// nearest core vertex is still undecided, such as the leaves of a vertex with children yet to come.
+class StreamingTreeOpening
+{
+public:
+  // The parent of a root
+  static const uint32_t NoParent = 0xffffffff;
+
+  // Called with (vertex, parent) for every kept edge
+  typedef std::function<void (uint32_t, uint32_t)> EdgeCallback;
+
+  StreamingTreeOpening(unsigned int numberOfIterations, const EdgeCallback& keptEdge);
+
+  // Read the next record. The parent must be the root or an ancestor of the previous vertex (or the
+  // previous vertex itself), otherwise std::runtime_error is thrown.
+  void AddVertex(const uint32_t vertex, const uint32_t parent);
+
+  // Finish the last tree. Must be called after the last record.
+  void Finish();
+
+  size_t GetNumberOfPendingEdges() const
+  {
+    return NumberOfPendingEdges;
+  }
+
+  size_t GetPeakNumberOfPendingEdges() const
+  {
+    return PeakNumberOfPendingEdges;
+  }
+
+  size_t GetMaximumDepth() const
+  {
+    return MaximumDepth;
+  }
+
+private:
+  // The fate of an edge for one class of the length of the longest path leaving the subtree through its root
+  enum Fate {DropEdge, KeepEdge, InheritFate};
+
+  typedef std::vector<std::pair<uint32_t, uint32_t> > EdgeList;
+
+  // Pending edges which share a fate for every class
+  struct PendingGroup
+  {
+    std::vector<uint8_t> Fates;
+    EdgeList Edges;
+  };
+
+  // A finished subtree which contains a core vertex for some class
+  struct Subtree
+  {
+    uint32_t Vertex;
+
+    // The height of the subtree plus one, capped at k + 2
+    uint32_t BranchLength;
+
+    // For every class, the fate of an edge outside the subtree whose nearest core vertex is found by
+    // entering the subtree, or InheritFate if it has no core vertex
+    std::vector<uint8_t> Anchors;
+
+    std::vector<PendingGroup> Groups;
+  };
+
+  // A vertex on the path from the root to the last vertex read
+  struct Frame
+  {
+    uint32_t Vertex;
+    uint32_t Parent;
+
+    // The two largest BranchLength of the finished children
+    uint32_t Longest;
+    uint32_t SecondLongest;
+
+    std::vector<Subtree> CoreSubtrees;
+
+    // The edges of the finished children without a core vertex, which all share the fate of a non-core
+    // edge at this vertex
+    EdgeList PlainEdges;
+  };
+
+  void FinishVertex();
+
+  void AddGroup(std::vector<PendingGroup>& groups, std::vector<uint8_t>& fates, EdgeList& edges, const bool isRoot);
+
+  void AddPendingEdges(const size_t numberOfEdges);
+
+  void RemovePendingEdges(EdgeList& edges, const bool keep);
+
+  unsigned int NumberOfIterations;
+  unsigned int NumberOfClasses;
+  EdgeCallback KeptEdge;
+
+  std::vector<Frame> Stack;
+
+  size_t NumberOfPendingEdges;
+  size_t PeakNumberOfPendingEdges;
+  size_t MaximumDepth;
+};
+
+// Write a forest as the input of StreamingTreeOpening: one "vertex parent" line per vertex in depth first
+// preorder, with -1 as the parent of a root. The trees are rooted at their smallest vertex.
+void WriteParentStream(const CompactGraph& forest, std::ostream& stream);
+
+#endif
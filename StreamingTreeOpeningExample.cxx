@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// This program opens a forest read as "vertex parent" lines in depth first preorder (-1 as the parent of a root),
+// such as the --stream output of PointCloudOpeningExample, and writes the kept edges as "vertex parent" lines.
+// Either file name may be - for the standard input or output, so the forest can be opened from a pipe
+// without ever being stored.
+
+// STL
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Custom
+#include "OpeningStatistics.h"
+#include "StreamingTreeOpening.h"
+
+int main(int argc, char *argv[])
+{
+  // Verify arguments
+  if(argc < 4)
+    {
+    std::cerr << "Required arguments: numberOfIterations input.txt|- output.txt|-" << std::endl;
+    return -1;
+    }
+
+  // Parse arguments
+  unsigned int numberOfIterations = 0;
+  std::stringstream ss(argv[1]);
+  ss >> numberOfIterations;
+
+  std::string inputFileName = argv[2];
+  std::string outputFileName = argv[3];
+
+  // Output arguments (to the standard error, as the output may be the standard output)
+  std::cerr << "Number of iterations: " << numberOfIterations << std::endl;
+  std::cerr << "Input: " << inputFileName << std::endl;
+  std::cerr << "Output: " << outputFileName << std::endl;
+
+  std::ios::sync_with_stdio(false);
+
+  std::ifstream fin;
+  if(inputFileName != "-")
+    {
+    fin.open(inputFileName.c_str());
+    if(!fin)
+      {
+      std::cerr << "Could not read " << inputFileName << std::endl;
+      return -1;
+      }
+    }
+  std::istream& input = inputFileName == "-" ? std::cin : fin;
+
+  std::ofstream fout;
+  if(outputFileName != "-")
+    {
+    fout.open(outputFileName.c_str());
+    }
+  std::ostream& output = outputFileName == "-" ? std::cout : fout;
+
+  size_t numberOfVertices = 0;
+  size_t numberOfKeptEdges = 0;
+  Timer timer;
+  StreamingTreeOpening opening(numberOfIterations, [&output, &numberOfKeptEdges](uint32_t vertex, uint32_t parent)
+    {
+    output << vertex << " " << parent << "\n";
+    numberOfKeptEdges++;
+    });
+
+  try
+    {
+    long long vertex;
+    long long parent;
+    while(input >> vertex >> parent)
+      {
+      opening.AddVertex(static_cast<uint32_t>(vertex),
+                        parent < 0 ? StreamingTreeOpening::NoParent : static_cast<uint32_t>(parent));
+      numberOfVertices++;
+      }
+    opening.Finish();
+    }
+  catch(const std::runtime_error& error)
+    {
+    std::cerr << error.what() << " (record " << numberOfVertices + 1 << ")" << std::endl;
+    return -1;
+    }
+  output.flush();
+
+  std::cerr << "Read " << numberOfVertices << " vertices and kept " << numberOfKeptEdges << " edges in "
+            << timer.GetElapsedSeconds() << " s" << std::endl;
+  std::cerr << "Maximum depth: " << opening.GetMaximumDepth() << ", at most "
+            << opening.GetPeakNumberOfPendingEdges() << " pending edges" << std::endl;
+
+  return EXIT_SUCCESS;
+}
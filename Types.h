@@ -36,7 +36,10 @@ struct EdgeVisibility
   // we set the string based on the bool.
   std::string VisibilityString; 
   
-  
+  // The position of the edge in boost::edges() of its graph, set by ReadGraph, CreateGraphFromKeepMask and
+  // IndexEdges(). Adding or removing edges makes it stale until IndexEdges() is called again. Code which has to be
+  // right for any graph finds the position with an EdgePositionMap instead.
+  unsigned int Index;
 };
 
 typedef boost::adjacency_list < boost::vecS, boost::vecS, boost::undirectedS, boost::no_property, EdgeVisibility> Graph;
@@ -0,0 +1,231 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "VertexOrdering.h"
+
+// STL
+#include <algorithm>
+#include <limits>
+
+static const uint32_t Unnumbered = std::numeric_limits<uint32_t>::max();
+
+// Append the vertices of the component of 'start' to 'order' in breadth first order, visiting the neighbors of
+// each vertex in increasing degree order if 'byDegree' is set. 'order' is used as the queue.
+static void AppendBreadthFirst(const CompactGraph& g, const uint32_t start, const bool byDegree,
+                               std::vector<uint32_t>& newIds, std::vector<uint32_t>& order)
+{
+  std::vector<uint32_t> neighbors;
+  size_t head = order.size();
+  newIds[start] = order.size();
+  order.push_back(start);
+  while(head < order.size())
+    {
+    const uint32_t v = order[head];
+    head++;
+    neighbors.clear();
+    g.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t)
+      {
+      if(newIds[neighbor] == Unnumbered)
+        {
+        newIds[neighbor] = 0;
+        neighbors.push_back(neighbor);
+        }
+      });
+    if(byDegree)
+      {
+      std::stable_sort(neighbors.begin(), neighbors.end(),
+                       [&](const uint32_t a, const uint32_t b) { return g.Degree(a) < g.Degree(b); });
+      }
+    for(size_t i = 0; i < neighbors.size(); ++i)
+      {
+      newIds[neighbors[i]] = order.size();
+      order.push_back(neighbors[i]);
+      }
+    }
+}
+
+static void AppendDepthFirst(const CompactGraph& g, const uint32_t start, std::vector<uint32_t>& newIds,
+                             std::vector<uint32_t>& order)
+{
+  // The stack holds (vertex, next slot to look at)
+  std::vector<std::pair<uint32_t, uint32_t> > stack;
+  newIds[start] = order.size();
+  order.push_back(start);
+  stack.push_back(std::make_pair(start, g.Offsets[start]));
+  while(!stack.empty())
+    {
+    const uint32_t v = stack.back().first;
+    uint32_t& slot = stack.back().second;
+    while(slot < g.Offsets[v + 1] && newIds[g.Neighbors[slot]] != Unnumbered)
+      {
+      slot++;
+      }
+    if(slot == g.Offsets[v + 1])
+      {
+      stack.pop_back();
+      continue;
+      }
+    const uint32_t neighbor = g.Neighbors[slot];
+    newIds[neighbor] = order.size();
+    order.push_back(neighbor);
+    stack.push_back(std::make_pair(neighbor, g.Offsets[neighbor]));
+    }
+}
+
+// Find a vertex far from 'start' with a low degree by repeated breadth first searches (George and Liu).
+static uint32_t FindPseudoPeripheralVertex(const CompactGraph& g, const uint32_t start, std::vector<uint32_t>& distances)
+{
+  std::vector<uint32_t> queue;
+  uint32_t vertex = start;
+  uint32_t eccentricity = 0;
+  for(unsigned int pass = 0; pass < 4; ++pass)
+    {
+    queue.assign(1, vertex);
+    distances[vertex] = 0;
+    for(size_t head = 0; head < queue.size(); ++head)
+      {
+      const uint32_t v = queue[head];
+      g.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t)
+        {
+        if(distances[neighbor] == Unnumbered)
+          {
+          distances[neighbor] = distances[v] + 1;
+          queue.push_back(neighbor);
+          }
+        });
+      }
+
+    // The farthest vertex with the lowest degree
+    const uint32_t farthestDistance = distances[queue.back()];
+    uint32_t farthest = queue.back();
+    for(size_t i = queue.size(); i > 0 && distances[queue[i - 1]] == farthestDistance; --i)
+      {
+      if(g.Degree(queue[i - 1]) < g.Degree(farthest))
+        {
+        farthest = queue[i - 1];
+        }
+      }
+    for(size_t i = 0; i < queue.size(); ++i)
+      {
+      distances[queue[i]] = Unnumbered;
+      }
+    if(pass > 0 && farthestDistance <= eccentricity)
+      {
+      break;
+      }
+    eccentricity = farthestDistance;
+    vertex = farthest;
+    }
+  return vertex;
+}
+
+GraphReordering ComputeReordering(const CompactGraph& g, OrderingMethod method)
+{
+  if(method == AutomaticOrdering)
+    {
+    method = (g.NumberOfEdges < g.NumberOfVertices) ? DepthFirstOrdering : ReverseCuthillMcKeeOrdering;
+    }
+
+  GraphReordering reordering;
+  std::vector<uint32_t>& newIds = reordering.NewVertexIds;
+  newIds.assign(g.NumberOfVertices, Unnumbered);
+  std::vector<uint32_t> order;
+  order.reserve(g.NumberOfVertices);
+  std::vector<uint32_t> distances;
+  if(method == ReverseCuthillMcKeeOrdering)
+    {
+    distances.assign(g.NumberOfVertices, Unnumbered);
+    }
+
+  for(uint32_t v = 0; v < g.NumberOfVertices; ++v)
+    {
+    if(newIds[v] != Unnumbered)
+      {
+      continue;
+      }
+    switch(method)
+      {
+      case BreadthFirstOrdering:
+        AppendBreadthFirst(g, v, false, newIds, order);
+        break;
+      case DepthFirstOrdering:
+        AppendDepthFirst(g, v, newIds, order);
+        break;
+      default:
+        AppendBreadthFirst(g, FindPseudoPeripheralVertex(g, v, distances), true, newIds, order);
+        break;
+      }
+    }
+
+  if(method == ReverseCuthillMcKeeOrdering)
+    {
+    for(uint32_t v = 0; v < g.NumberOfVertices; ++v)
+      {
+      newIds[v] = g.NumberOfVertices - 1 - newIds[v];
+      }
+    std::reverse(order.begin(), order.end());
+    }
+
+  // Number the edges in the order they are reached from the vertices in their new order
+  reordering.NewEdgeIds.assign(g.NumberOfEdges, Unnumbered);
+  uint32_t numberOfEdges = 0;
+  for(size_t i = 0; i < order.size(); ++i)
+    {
+    g.ForEachNeighbor(order[i], [&](const uint32_t, const uint32_t edgeId)
+      {
+      if(reordering.NewEdgeIds[edgeId] == Unnumbered)
+        {
+        reordering.NewEdgeIds[edgeId] = numberOfEdges;
+        numberOfEdges++;
+        }
+      });
+    }
+  return reordering;
+}
+
+CompactGraph ReorderCompactGraph(const CompactGraph& g, const GraphReordering& reordering)
+{
+  std::vector<uint32_t> sources(g.NumberOfEdges);
+  std::vector<uint32_t> targets(g.NumberOfEdges);
+  for(uint32_t v = 0; v < g.NumberOfVertices; ++v)
+    {
+    g.ForEachNeighbor(v, [&](const uint32_t neighbor, const uint32_t edgeId)
+      {
+      // Every edge is seen from both of its end points (twice from a self loop), which write the same values
+      const uint32_t newEdgeId = reordering.NewEdgeIds[edgeId];
+      sources[newEdgeId] = reordering.NewVertexIds[std::min(v, neighbor)];
+      targets[newEdgeId] = reordering.NewVertexIds[std::max(v, neighbor)];
+      });
+    }
+
+  EdgeArrays edges;
+  edges.Sources = sources.data();
+  edges.Targets = targets.data();
+  edges.NumberOfEdges = sources.size();
+  return CreateCompactGraph(edges, g.NumberOfVertices);
+}
+
+std::vector<bool> MapKeepMaskBack(const std::vector<bool>& keep, const GraphReordering& reordering)
+{
+  std::vector<bool> originalKeep(reordering.NewEdgeIds.size());
+  for(size_t edgeId = 0; edgeId < reordering.NewEdgeIds.size(); ++edgeId)
+    {
+    originalKeep[edgeId] = keep[reordering.NewEdgeIds[edgeId]];
+    }
+  return originalKeep;
+}
@@ -0,0 +1,78 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef VERTEXORDERING_H
+#define VERTEXORDERING_H
+
+// STL
+#include <vector>
+
+// C
+#include <stdint.h>
+
+// Custom
+#include "CompactGraph.h"
+
+// Vertex ids usually come from the order in which a file or an image was scanned, so the neighbors of a
+// vertex can be anywhere in memory. Renumbering the vertices along the graph makes the frontiers of an
+// opening walk through memory in order. The opening is run on the renumbered graph and its keep-mask
+// is mapped back, so callers only ever see the original ids.
+
+enum OrderingMethod
+{
+  // Depth first order for graphs with fewer edges than vertices (trees and forests), otherwise reverse Cuthill-McKee.
+  AutomaticOrdering,
+  BreadthFirstOrdering,
+  // Preorder, which stores every branch of a tree contiguously.
+  DepthFirstOrdering,
+  // Breadth first from a pseudo-peripheral vertex visiting low degree neighbors first, reversed.
+  // This keeps the bandwidth of graphs with cycles small.
+  ReverseCuthillMcKeeOrdering
+};
+
+// A renumbering of the vertices and edges of a graph.
+struct GraphReordering
+{
+  // The new id of every vertex/edge, indexed by the old id.
+  std::vector<uint32_t> NewVertexIds;
+  std::vector<uint32_t> NewEdgeIds;
+};
+
+// Compute a renumbering which improves the memory locality of 'g'. The edges are numbered in the
+// order they are reached from the renumbered vertices.
+GraphReordering ComputeReordering(const CompactGraph& g, OrderingMethod method = AutomaticOrdering);
+
+// Create a copy of 'g' with renumbered vertices and edges.
+CompactGraph ReorderCompactGraph(const CompactGraph& g, const GraphReordering& reordering);
+
+// Map a keep-mask of the reordered graph back onto the edges of the original graph.
+std::vector<bool> MapKeepMaskBack(const std::vector<bool>& keep, const GraphReordering& reordering);
+
+// Map per-vertex values (such as the rounds of a PeelResult) of the reordered graph back onto the original vertices.
+template <typename T>
+std::vector<T> MapVertexValuesBack(const std::vector<T>& values, const GraphReordering& reordering)
+{
+  std::vector<T> originalValues(reordering.NewVertexIds.size());
+  for(size_t v = 0; v < reordering.NewVertexIds.size(); ++v)
+    {
+    originalValues[v] = values[reordering.NewVertexIds[v]];
+    }
+  return originalValues;
+}
+
+#endif